@@ -7,11 +7,18 @@
 #include <vector>
 #include <array>
 #include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
+#include "dispatch_x_vars.h"
 
 
 namespace MLComparison
 {
-	// class template for a tabular dataset suitable for a decision tree model
+	// class template for a tabular dataset suitable for a decision tree model, whose number of independent variables
+	// is either fixed, so that each row is an array, or dynamic_x_vars, in which case it is read from the csv file
+	// and each row is a vector
 	template<typename T, int x_vars, bool includes_y = true>
 	class DecisionTreeDataset
 	{
@@ -58,6 +65,20 @@ namespace MLComparison
 		}
 
 
+		// returns a pointer to the contiguous values of independent variable col, ordered by row
+		const T* column_data(int col) const
+		{
+			return columns.data() + col * data_table.size();
+		}
+
+
+		// returns a pointer to the contiguous class values of the dependent variable, ordered by row
+		const uint8_t* label_data() const
+		{
+			return labels.data();
+		}
+
+
 		// returns an iterator pointing to the first element (row) of the data table
 		auto begin()
 		{
@@ -120,25 +141,102 @@ namespace MLComparison
 
 
 		// returns the number of columns in the dataset
-		auto get_n_cols()
+		auto get_n_cols() const
 		{
 			return n_cols;
 		}
 
 
 		// returns the number of independent variables in the dataset
-		auto get_n_x_vars()
+		auto get_n_x_vars() const
 		{
 			return n_x_vars;
 		}
 
 
+		// returns whether the independent variables have been quantized into bins
+		bool is_quantized()
+		{
+			return !binned_columns.empty();
+		}
+
+
+		// returns the number of bins into which an independent variable has been quantized
+		int get_n_bins(int col)
+		{
+			return static_cast<int>(bin_thresholds[col].size()) + 1;
+		}
+
+
+		// returns the lower bound of one of an independent variable's bins, i.e. the split value below
+		// which all of the variable's values fall into the lower bins, for any bin except the first
+		T get_bin_threshold(int col, int bin)
+		{
+			return bin_thresholds[col][bin - 1];
+		}
+
+
+		// returns a pointer to the contiguous bin codes of independent variable col, ordered by row
+		const uint8_t* binned_column_data(int col) const
+		{
+			return binned_columns.data() + col * data_table.size();
+		}
+
+
+		// quantizes each independent variable into at most max_bins bins bounded by quantiles of its
+		// values, and stores the bin of each value as an 8-bit code in a column alongside the data table
+		void quantize(int max_bins = 256)
+		{
+			// codes are stored in 8 bits
+			max_bins = std::min(std::max(max_bins, 2), 256);
+			// number of rows in the data table
+			size_t n_rows = data_table.size();
+
+			// allocate a column of bin codes and a list of bin lower bounds for each independent variable
+			binned_columns.assign(n_x_vars * n_rows, 0);
+			bin_thresholds.assign(n_x_vars, {});
+
+			// values of the current variable in ascending order
+			std::vector<T> sorted_values(n_rows);
+			// for each independent variable
+			for (int col = 0; col < n_x_vars; col++)
+			{
+				// sort the variable's values
+				const T* column = column_data(col);
+				std::copy(column, column + n_rows, sorted_values.begin());
+				std::sort(sorted_values.begin(), sorted_values.end());
+
+				// the lower bound of each bin after the first is a quantile of the variable's values,
+				// skipping any quantile equal to the one before so every bin holds at least one value
+				bin_thresholds[col].clear();
+				for (int bin = 1; bin < max_bins && n_rows > 0; bin++)
+				{
+					T threshold = sorted_values[bin * n_rows / max_bins];
+					if (threshold > sorted_values.front() && (bin_thresholds[col].empty() || threshold > bin_thresholds[col].back()))
+					{
+						bin_thresholds[col].push_back(threshold);
+					}
+				}
+
+				// the code of each value is the number of bin lower bounds less than or equal to it, so that a
+				// value is less than the lower bound of a bin if and only if its code is less than that bin
+				uint8_t* binned_column = binned_columns.data() + col * n_rows;
+				for (size_t row = 0; row < n_rows; row++)
+				{
+					auto bin = std::upper_bound(bin_thresholds[col].begin(), bin_thresholds[col].end(), column[row]);
+					binned_column[row] = static_cast<uint8_t>(std::distance(bin_thresholds[col].begin(), bin));
+				}
+			}
+		}
+
+
 		// loads data from a csv file
 		void load_data(const std::string& csv_file)
 		{
-			// clear data table and row indices
+			// clear data table, row indices, columns and any bins
 			data_table.clear();
 			row_indices.clear();
+			binned_columns.clear();
 			// open csv file
 			std::ifstream infile(csv_file);
 			// create string and stream for storing the current line
@@ -149,10 +247,16 @@ namespace MLComparison
 			// for each row in the file, get the current line
 			for (int row = 0; std::getline(infile, line); row++)
 			{
+				// if the width is dynamic, count the columns in the first line
+				if (is_dynamic && row == 0)
+				{
+					n_cols = static_cast<int>(std::count(line.begin(), line.end(), ',')) + 1;
+					n_x_vars = n_cols - (includes_y ? 1 : 0);
+				}
 				// add current row index to vector of row indices
 				row_indices.emplace_back(row);
-				// construct a new array in the vector of rows for the current row
-				data_table.emplace_back();
+				// construct a new row of zeroes in the vector of rows for the current row
+				data_table.push_back(make_row(std::integral_constant<bool, is_dynamic>()));
 				// set up line stream
 				line_stream = std::istringstream(line);
 				// for each field in the row
@@ -164,6 +268,9 @@ namespace MLComparison
 					data_table[row][col] = std::stod(item);
 				}
 			}
+
+			// copy the data table into columns
+			build_columns();
 		}
 
 
@@ -183,15 +290,73 @@ namespace MLComparison
 
 	private:
 
-		// number of dependent variables in the dataset
-		static const int n_x_vars = x_vars;
-		// total number of columns in the dataset including the independent variable if present
-		static const int n_cols = x_vars + (includes_y ? 1 : 0);
+		// whether the number of independent variables is read from the csv file
+		static const bool is_dynamic = x_vars == dynamic_x_vars;
+		// alias for a row of the data table, an array unless the number of independent variables is dynamic
+		using Row = typename std::conditional<is_dynamic, std::vector<T>, std::array<T, (is_dynamic ? 1 : x_vars + (includes_y ? 1 : 0))>>::type;
+
+
+		// returns a new row for a dataset of fixed width
+		Row make_row(std::false_type) const
+		{
+			return Row();
+		}
+
+
+		// returns a new row for a dataset whose width is read from its csv file
+		Row make_row(std::true_type) const
+		{
+			return Row(n_cols, T(0));
+		}
+
 
-		// vector of arrays where each array corresponds to a data sample/row
-		std::vector<std::array<T, n_cols>> data_table = {};
+		// copies each independent variable of the data table into its own contiguous column, and the
+		// dependent variable if present into a column of 8-bit class values, so that a variable can be
+		// scanned over a group of rows without striding over the other variables
+		void build_columns()
+		{
+			// number of rows in the data table
+			size_t n_rows = data_table.size();
+
+			// for each independent variable, copy its value from each row
+			columns.resize(n_x_vars * n_rows);
+			for (int col = 0; col < n_x_vars; col++)
+			{
+				T* column = columns.data() + col * n_rows;
+				for (size_t row = 0; row < n_rows; row++)
+				{
+					column[row] = data_table[row][col];
+				}
+			}
+
+			// copy the class value of each row if the dataset includes the dependent variable
+			labels.resize(includes_y ? n_rows : 0);
+			for (size_t row = 0; row < labels.size(); row++)
+			{
+				labels[row] = static_cast<uint8_t>(data_table[row][n_cols - 1]);
+			}
+		}
+
+
+		// number of independent variables in the dataset
+		int n_x_vars = x_vars;
+		// total number of columns in the dataset including the dependent variable if present
+		int n_cols = x_vars + (includes_y ? 1 : 0);
+
+		// vector of rows where each row corresponds to a data sample
+		std::vector<Row> data_table = {};
 		// vector of row indices determining the order in which rows are accessed,
 		// which is recursively partitioned into groups as a decision tree is trained
 		std::vector<int> row_indices = {};
+
+		// values of each independent variable stored column by column, i.e. in column-major order
+		std::vector<T> columns = {};
+		// class values of the dependent variable
+		std::vector<uint8_t> labels = {};
+
+		// lower bounds of each independent variable's bins after the first, in ascending order
+		std::vector<std::vector<T>> bin_thresholds = {};
+		// bin codes of each independent variable stored column by column, i.e. in column-major order
+		std::vector<uint8_t> binned_columns = {};
 	};
 }
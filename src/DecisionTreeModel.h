@@ -5,9 +5,17 @@
 #include <cmath>
 #include <memory>
 #include <iterator>
+#include <vector>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
 
 #include "DecisionTreeDataset.h"
 #include "DecisionTreeNode.h"
+#include "DecisionTreeSettings.h"
+#include "DecisionTreeWorkspace.h"
+#include "FlatDecisionTree.h"
+#include "WorkStealingThreadPool.h"
 #include "calculate_rows_to_use.h"
 
 
@@ -43,6 +51,27 @@ namespace MLComparison
 		}
 
 
+		// get training settings
+		const DecisionTreeSettings& get_settings()
+		{
+			return settings;
+		}
+
+
+		// set training settings, which apply from the next call to train
+		void set_settings(const DecisionTreeSettings& new_settings)
+		{
+			settings = new_settings;
+		}
+
+
+		// set the method used to search for the best split point of each node
+		void set_split_method(SplitMethod new_split_method)
+		{
+			settings.split_method = new_split_method;
+		}
+
+
 		// loads a csv file as the training set
 		void load_training_set_file(const std::string& csv_file)
 		{
@@ -63,29 +92,237 @@ namespace MLComparison
 		{
 			// number of rows to use
 			size_t rows_to_use = calculate_rows_to_use(8, eighths_rows_to_use, training_set_ptr->size());
+			// number of fields to use, which cannot exceed the number in the training set, whose width may be read from its file
+			x_vars_to_use = std::min(x_vars_to_use, static_cast<size_t>(training_set_ptr->get_n_x_vars()));
 
 			// get iterator pointing to beginning of training set row indices
 			auto training_set_begin = training_set_ptr->indices_begin();
 			// get iterator pointing to one after the last training sample to use
 			auto training_set_end = training_set_ptr->indices_end(rows_to_use);
 
-			// create the root node of the decision tree
-			root_node_ptr.reset(new DecisionTreeNode<T, dataset_x_vars>(0, training_set_begin, training_set_end, training_set_ptr, x_vars_to_use));
+			// quantize the training set once if class histograms are used, which is done
+			// as part of loading the data rather than training, as it need not be repeated
+			if (uses_histograms(settings) && !training_set_ptr->is_quantized())
+			{
+				training_set_ptr->quantize();
+			}
+
+			// get the thread pool, if any, before timing, as starting its threads is not part of training
+			WorkStealingThreadPool* thread_pool = get_thread_pool();
+
+			// record the number of training rows used, from which the tree may later be pruned
+			training_rows_used = rows_to_use;
 
 			// get start time
 			the_clock::time_point start = the_clock::now();
 
+			// sort the training rows by each variable once if the sorted sweep split method is used
+			std::shared_ptr<DecisionTreeWorkspace<T, dataset_x_vars>> workspace_ptr = nullptr;
+			if (uses_sorted_indices(settings))
+			{
+				workspace_ptr.reset(new DecisionTreeWorkspace<T, dataset_x_vars>(training_set_ptr, training_set_begin, training_set_end, x_vars_to_use));
+			}
+
+			// create the tree's context, freeing any previous tree at once, and the root node of the decision tree
+			tree_context_ptr.reset(new DecisionTreeContext<T, dataset_x_vars>(*training_set_ptr, x_vars_to_use, settings, workspace_ptr.get(), thread_pool));
+			root_node_ptr = tree_context_ptr->create_root(training_set_begin, training_set_end);
+
 			// train the root node, which recursively creates and trains child nodes
 			root_node_ptr->train();
+			// the workspace is freed once training ends
+			tree_context_ptr->workspace = nullptr;
 
 			// get end time
 			the_clock::time_point end = the_clock::now();
 
+			// compile the trained tree into the flat layout used for prediction
+			compile();
+
 			// return number of microseconds taken
 			return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
 		}
 
 
+		// compiles the trained decision tree into a contiguous array of nodes from which predictions are made
+		void compile()
+		{
+			flat_tree.compile(*root_node_ptr);
+		}
+
+
+		// method template for making a prediction based on a sample using the compiled tree
+		template<typename SampleType>
+		int predict(const SampleType& sample) const
+		{
+			return flat_tree.predict(sample);
+		}
+
+
+		// method template for making predictions for a range of samples using the compiled tree,
+		// writing them to the given output iterator
+		template<typename RowIterator, typename OutputIterator>
+		void predict_batch(RowIterator first, RowIterator last, OutputIterator predictions) const
+		{
+			flat_tree.predict_batch(first, last, predictions);
+		}
+
+
+		// returns the compiled decision tree
+		const FlatDecisionTree& get_flat_tree() const
+		{
+			return flat_tree;
+		}
+
+
+		// saves the compiled decision tree to a binary file, from which load_model can restore it
+		void save_model(const std::string& file_name) const
+		{
+			if (flat_tree.empty())
+			{
+				throw std::logic_error("DecisionTreeModel: no trained tree to save");
+			}
+			flat_tree.save(file_name);
+		}
+
+
+		// exports the compiled decision tree as a self-contained C++ header defining a function template of the given
+		// name which makes the tree's predictions by nested comparisons against constant split values
+		void export_header(const std::string& file_name, const std::string& function_name) const
+		{
+			if (flat_tree.empty())
+			{
+				throw std::logic_error("DecisionTreeModel: no trained tree to export");
+			}
+			flat_tree.export_header(file_name, function_name);
+		}
+
+
+		// loads a compiled decision tree saved by save_model in place of the trained tree, memory-mapping the file
+		// where possible so that predictions are made from it directly; a loaded tree can be used for prediction
+		// and validation but not pruned, as it holds none of the training state, and throws std::runtime_error if
+		// the file is not a valid tree or splits on a variable the model's samples do not have
+		void load_model(const std::string& file_name)
+		{
+			FlatDecisionTree loaded_tree;
+			loaded_tree.load(file_name);
+			for (size_t i = 0; i < loaded_tree.size(); i++)
+			{
+				if (loaded_tree.data()[i].left != 0 && loaded_tree.data()[i].split_var >= validation_set.get_n_x_vars())
+				{
+					throw std::runtime_error("DecisionTreeModel: " + file_name + " splits on a variable the model's samples do not have");
+				}
+			}
+
+			// free any trained tree, which the loaded tree replaces
+			root_node_ptr = nullptr;
+			tree_context_ptr = nullptr;
+			flat_tree = loaded_tree;
+		}
+
+
+		// prunes the trained decision tree by minimal cost-complexity pruning, where a subtree is collapsed into a leaf
+		// once the complexity parameter alpha exceeds the increase in training misclassifications per leaf removed, and
+		// alpha is chosen as the largest value in the pruning sequence whose tree has the best accuracy on the validation
+		// set, which the unpruned tree is a candidate for; the pruned tree is then recompiled, which drops the removed
+		// nodes, and the chosen alpha is returned, or -1 if the tree is not pruned
+		double prune()
+		{
+			if (root_node_ptr == nullptr)
+			{
+				throw std::logic_error("DecisionTreeModel: only a tree trained by this model can be pruned");
+			}
+
+			// list the tree's nodes in breadth-first order, with the indices of their children
+			std::vector<PruningNode> nodes = { { root_node_ptr, -1, -1, 0, 0, std::numeric_limits<double>::infinity() } };
+			for (size_t i = 0; i < nodes.size(); i++)
+			{
+				if (!nodes[i].node->is_leaf())
+				{
+					nodes[i].left = static_cast<int>(nodes.size());
+					nodes.push_back({ nodes[i].node->get_left(), -1, -1, 0, 0, std::numeric_limits<double>::infinity() });
+					nodes[i].right = static_cast<int>(nodes.size());
+					nodes.push_back({ nodes[i].node->get_right(), -1, -1, 0, 0, std::numeric_limits<double>::infinity() });
+				}
+			}
+
+			// count the training rows which reach each node and sum their class values, sending each row down
+			// the same side of each split as when the node's group was partitioned
+			const uint8_t* labels = training_set_ptr->label_data();
+			for (auto it = training_set_ptr->indices_begin(); it < training_set_ptr->indices_end(training_rows_used); ++it)
+			{
+				for (int i = 0; i >= 0;)
+				{
+					PruningNode& node = nodes[i];
+					node.group_size++;
+					node.class_val_sum += labels[*it];
+					i = node.left < 0 ? -1 :
+						(training_set_ptr->column_data(node.node->get_split_var())[*it] < node.node->get_split_val() ? node.left : node.right);
+				}
+			}
+
+			// find the weakest links of the current tree in turn, i.e. the nodes whose subtrees remove the fewest
+			// training misclassifications per extra leaf, and record the alpha at which each node is collapsed
+			std::vector<double> alphas;
+			std::vector<double> subtree_errors(nodes.size());
+			std::vector<int> subtree_leaves(nodes.size());
+			while (nodes[0].left >= 0 && nodes[0].collapse_alpha == std::numeric_limits<double>::infinity())
+			{
+				// misclassifications and leaves of each node's subtree in the current tree, from the leaves up
+				double alpha = std::numeric_limits<double>::infinity();
+				for (size_t i = nodes.size(); i-- > 0;)
+				{
+					if (nodes[i].left < 0 || nodes[i].collapse_alpha < std::numeric_limits<double>::infinity())
+					{
+						subtree_errors[i] = nodes[i].leaf_errors();
+						subtree_leaves[i] = 1;
+					}
+					else
+					{
+						subtree_errors[i] = subtree_errors[nodes[i].left] + subtree_errors[nodes[i].right];
+						subtree_leaves[i] = subtree_leaves[nodes[i].left] + subtree_leaves[nodes[i].right];
+						alpha = std::min(alpha, nodes[i].link_strength(subtree_errors[i], subtree_leaves[i]));
+					}
+				}
+				// collapse every node of the current tree which is as weak as the weakest link
+				for (size_t i = 0; i < nodes.size(); i++)
+				{
+					if (nodes[i].left >= 0 && nodes[i].collapse_alpha == std::numeric_limits<double>::infinity() && subtree_leaves[i] > 1 &&
+						nodes[i].link_strength(subtree_errors[i], subtree_leaves[i]) <= alpha)
+					{
+						nodes[i].collapse_alpha = alpha;
+					}
+				}
+				alphas.push_back(alpha);
+			}
+
+			// choose the largest alpha whose tree is at least as accurate on the validation set as any other,
+			// starting with the unpruned tree
+			double best_alpha = -1;
+			int best_correct = count_correct_after_pruning(nodes, best_alpha);
+			for (double alpha : alphas)
+			{
+				int correct = count_correct_after_pruning(nodes, alpha);
+				if (correct >= best_correct)
+				{
+					best_alpha = alpha;
+					best_correct = correct;
+				}
+			}
+
+			// collapse the nodes pruned at the chosen alpha and recompile the tree
+			for (const auto& node : nodes)
+			{
+				if (node.left >= 0 && node.collapse_alpha <= best_alpha)
+				{
+					node.node->collapse(node.leaf_prediction());
+				}
+			}
+			compile();
+
+			return best_alpha;
+		}
+
+
 		// determine the model's accuracy using the validation set
 		long long validate(uint8_t eighths_rows_to_use)
 		{
@@ -94,6 +331,8 @@ namespace MLComparison
 
 			// total correct predictions
 			T total_correct = 0;
+			// model's predictions for the validation set
+			std::vector<int> predictions(validation_set.size());
 
 			// get start time
 			the_clock::time_point start = the_clock::now();
@@ -101,17 +340,15 @@ namespace MLComparison
 			// get end iterator
 			auto end_iterator = validation_set.begin();
 			std::advance(end_iterator, rows_to_use);
+			// get model's predictions for the samples in the validation set
+			flat_tree.predict_batch(validation_set.begin(), end_iterator, predictions.begin());
 			// for each sample in the validation set
-			for (auto it = validation_set.begin(); it < end_iterator; ++it)
+			for (size_t i = 0; i < rows_to_use; i++)
 			{
-				// get sample
-				auto& sample = *it;
-				// get model's prediction
-				auto prediction = root_node_ptr->predict(sample);
 				// get target value
-				auto target = sample[dataset_x_vars];
+				auto target = validation_set[i][validation_set.get_n_x_vars()];
 				// add whether prediction is correct to total correct predictions
-				total_correct += (prediction == target);
+				total_correct += (predictions[i] == target);
 			}
 
 			// get end time
@@ -123,15 +360,15 @@ namespace MLComparison
 			// total correct predictions
 			total_correct = 0;
 
+			// get model's predictions for all the samples in the validation set
+			flat_tree.predict_batch(validation_set.begin(), validation_set.end(), predictions.begin());
 			// for each sample in the validation set
-			for (auto& sample : validation_set)
+			for (size_t i = 0; i < validation_set.size(); i++)
 			{
-				// get model's prediction
-				auto prediction = root_node_ptr->predict(sample);
 				// get target value
-				auto target = sample[dataset_x_vars];
+				auto target = validation_set[i][validation_set.get_n_x_vars()];
 				// add whether prediction is correct to total correct predictions
-				total_correct += (prediction == target);
+				total_correct += (predictions[i] == target);
 			}
 
 			// calculate and record validation accuracy
@@ -144,16 +381,101 @@ namespace MLComparison
 	
 	private:
 
+		// struct for a node of the tree while it is being pruned, with the indices of its children in the list
+		// of nodes, the number and class value sum of the training rows which reach it, and the alpha at which
+		// its subtree is collapsed into a leaf
+		struct PruningNode
+		{
+			DecisionTreeNode<T, dataset_x_vars>* node;
+			int left;
+			int right;
+			int group_size;
+			int class_val_sum;
+			double collapse_alpha;
+
+
+			// returns the class the node predicts as a leaf, which is whichever class is more prevalent in its group
+			int leaf_prediction() const
+			{
+				return (class_val_sum > group_size / 2) ? 1 : 0;
+			}
+
+
+			// returns the number of training rows the node misclassifies as a leaf
+			double leaf_errors() const
+			{
+				return leaf_prediction() ? group_size - class_val_sum : class_val_sum;
+			}
+
+
+			// returns the alpha at which the node's subtree, with the given misclassifications and leaves, costs
+			// as much as the node does as a leaf
+			double link_strength(double errors, int leaves) const
+			{
+				return (leaf_errors() - errors) / (leaves - 1);
+			}
+		};
+
+
+		// returns the number of samples of the validation set the tree predicts correctly with the nodes pruned
+		// at the given alpha collapsed into leaves
+		int count_correct_after_pruning(const std::vector<PruningNode>& nodes, double alpha)
+		{
+			int correct = 0;
+			for (size_t row = 0; row < validation_set.size(); row++)
+			{
+				const auto& sample = validation_set[row];
+				int i = 0;
+				while (nodes[i].left >= 0 && nodes[i].collapse_alpha > alpha)
+				{
+					i = sample[nodes[i].node->get_split_var()] < nodes[i].node->get_split_val() ? nodes[i].left : nodes[i].right;
+				}
+				correct += (nodes[i].leaf_prediction() == sample[validation_set.get_n_x_vars()]);
+			}
+			return correct;
+		}
+
+
 		// accuracy of the model on the validation set
 		T validation_accuracy = 0;
 
+		// number of training rows with which the tree was last trained
+		size_t training_rows_used = 0;
+
+		// settings which control how the decision tree is trained
+		DecisionTreeSettings settings;
+
 		// shared pointer to the training set
 		std::shared_ptr<DecisionTreeDataset<T, dataset_x_vars>> training_set_ptr = nullptr;
 		// validation set
 		DecisionTreeDataset<T, dataset_x_vars> validation_set;
 
-		// unique pointer to the root node of the decision tree
-		std::unique_ptr<DecisionTreeNode<T, dataset_x_vars>> root_node_ptr = nullptr;
+		// returns a pointer to the thread pool used for training, which is created on first use, or null to train serially;
+		// the calling thread works alongside the pool's workers, so the pool has one fewer worker than there are threads
+		WorkStealingThreadPool* get_thread_pool()
+		{
+			if (settings.n_threads <= 1)
+			{
+				return nullptr;
+			}
+			if (thread_pool_ptr == nullptr || thread_pool_ptr->size() != static_cast<size_t>(settings.n_threads - 1))
+			{
+				thread_pool_ptr.reset(new WorkStealingThreadPool(settings.n_threads - 1));
+			}
+			return thread_pool_ptr.get();
+		}
+
+
+		// thread pool used for training with more than one thread
+		std::unique_ptr<WorkStealingThreadPool> thread_pool_ptr = nullptr;
+
+		// unique pointer to the context of the decision tree, which owns its nodes
+		std::unique_ptr<DecisionTreeContext<T, dataset_x_vars>> tree_context_ptr = nullptr;
+		// pointer to the root node of the decision tree
+		DecisionTreeNode<T, dataset_x_vars>* root_node_ptr = nullptr;
+
+		// the trained decision tree compiled into a contiguous array of nodes for prediction
+		FlatDecisionTree flat_tree;
 
 		// alias for chrono::steady_clock used for performance measurement
 		using the_clock = std::chrono::steady_clock;
@@ -6,26 +6,38 @@
 #include <iterator>
 #include <iostream>
 #include <algorithm>
+#include <limits>
+#include <random>
+#include <cstdint>
 
 #include "DecisionTreeDataset.h"
+#include "DecisionTreeSettings.h"
+#include "DecisionTreeWorkspace.h"
+#include "WorkStealingThreadPool.h"
+#include "NodeArena.h"
 
 
 namespace MLComparison
 {
+	template<typename T, int dataset_x_vars>
+	struct DecisionTreeContext;
+
+
 	// class template for a binary classification decision tree node which deals with data samples of a certain type and size
 	template<typename T, int dataset_x_vars>
 	class DecisionTreeNode
 	{
 	public:
 
-		// constructor which takes the depth of the current node, iterators defining the training group,
-		// a pointer to the training dataset, and the number of training set indepenent variables to use
+		// constructor which takes the depth of the current node, iterators defining the training group and
+		// a pointer to the context of the tree, which holds everything its nodes share and owns the nodes
 		DecisionTreeNode(int node_depth, std::vector<int>::iterator group_begin_it, std::vector<int>::iterator group_end_it,
-			std::shared_ptr<DecisionTreeDataset<T, dataset_x_vars>> training_dataset, int dataset_x_vars_to_use = dataset_x_vars) :
-			depth(node_depth), group_begin(group_begin_it), group_end(group_end_it), 
-			training_set(training_dataset), x_vars_to_use(dataset_x_vars_to_use)
+			DecisionTreeContext<T, dataset_x_vars>* tree_context) :
+			depth(node_depth), context(tree_context), group_begin(group_begin_it), group_end(group_end_it)
 		{
 			group_size = std::distance(group_begin, group_end);
+			// the root node's seed is the tree's, from which its descendants' seeds are derived
+			node_seed = context->settings.seed;
 		}
 
 
@@ -34,14 +46,15 @@ namespace MLComparison
 			split_var(rhs.split_var),
 			split_val(rhs.split_val),
 			class_prediction(rhs.class_prediction),
+			split_gini_index(rhs.split_gini_index),
 			depth(rhs.depth),
 			left(nullptr),
 			right(nullptr),
-			training_set(rhs.training_set),
-			x_vars_to_use(rhs.x_vars_to_use),
+			context(rhs.context),
 			group_begin(rhs.group_begin),
 			group_end(rhs.group_end),
-			group_size(rhs.group_size)
+			group_size(rhs.group_size),
+			node_seed(rhs.node_seed)
 		{
 		}
 
@@ -52,27 +65,52 @@ namespace MLComparison
 			split_var = rhs.split_var;
 			split_val = rhs.split_var;
 			class_prediction = rhs.class_prediction;
+			split_gini_index = rhs.split_gini_index;
 			depth = rhs.depth;
-			left.reset(nullptr);
-			right.reset(nullptr);
-			training_set = rhs.training_set;
-			x_vars_to_use = rhs.x_vars_to_use;
+			left = nullptr;
+			right = nullptr;
+			context = rhs.context;
 			group_begin = rhs.group_begin;
 			group_end = rhs.group_end;
 			group_size = rhs.group_size;
+			node_seed = rhs.node_seed;
 			return *this;
 		}
 
 
+		// type of a class histogram of a group, holding the number of rows and sum of class values
+		// which fall into each bin of each independent variable, stored variable by variable
+		using Histogram = std::vector<std::array<int, 2>>;
+
+
 		// trains the node on its group of training samples, determining the optimal split variable and value
 		// and either setting its class prediction or recursively creating and training its child nodes
 		void train()
+		{
+			if (context->settings.growth_policy == GrowthPolicy::level_wise)
+			{
+				train_level_wise();
+			}
+			else if (context->settings.growth_policy == GrowthPolicy::best_first)
+			{
+				train_best_first();
+			}
+			else
+			{
+				train(Histogram());
+			}
+		}
+
+
+		// trains the node as above, taking the class histogram of its group if it has already been
+		// derived by its parent, otherwise building it when the histogram split method is used
+		void train(Histogram&& histogram)
 		{
 			// if depth is low enough and group size large enough
-			if (depth < 6 && group_size > 10)
+			if (can_split(depth, group_size))
 			{
-				// determine best split variable and value
-				get_best_split();
+				// determine best split variable and value using the configured split method
+				search_split(histogram);
 				// partition the node's group of training row indices and return an iterator pointing to the split point
 				auto split_point = split_group();
 				// become leaf node if best split is not to split
@@ -83,10 +121,23 @@ namespace MLComparison
 				// otherwise, create and train child nodes
 				else
 				{
-					left.reset(new DecisionTreeNode<T, dataset_x_vars>(depth + 1, group_begin, split_point, training_set, x_vars_to_use));
-					right.reset(new DecisionTreeNode<T, dataset_x_vars>(depth + 1, split_point, group_end, training_set, x_vars_to_use));
-					left->train();
-					right->train();
+					Histogram left_histogram;
+					Histogram right_histogram;
+					create_children(split_point, std::move(histogram), left_histogram, right_histogram);
+					// train the left child as a task on the thread pool if it is large enough to be worth it,
+					// as the children's groups occupy disjoint ranges of the row indices and sorted lists
+					if (context->thread_pool != nullptr && left->group_size >= context->settings.parallel_min_group_size)
+					{
+						TaskGroup left_task(*context->thread_pool);
+						left_task.run([this, &left_histogram]() { left->train(std::move(left_histogram)); });
+						right->train(std::move(right_histogram));
+						left_task.wait();
+					}
+					else
+					{
+						left->train(std::move(left_histogram));
+						right->train(std::move(right_histogram));
+					}
 				}
 			}
 			// otherwise, become leaf node
@@ -97,9 +148,310 @@ namespace MLComparison
 		}
 
 
+		// trains the tree of which this is the root node best first, keeping a priority queue of candidate leaves
+		// ordered by the reduction in Gini impurity their best splits would make, weighted by group size, and splitting
+		// the best candidate until the tree has the maximum number of leaves or no split reduces the impurity, which
+		// spends the tree's nodes where splits help most rather than evenly across its levels
+		void train_best_first()
+		{
+			// candidate leaves, kept as a heap with the best candidate first
+			std::vector<LeafCandidate> candidates;
+			auto is_worse = [](const LeafCandidate& a, const LeafCandidate& b) -> bool {
+				return a.gini_reduction < b.gini_reduction || (a.gini_reduction == b.gini_reduction && a.order > b.order);
+			};
+			int n_candidates = 0;
+			// searches a leaf for its best split, adding it to the candidates if the split reduces the impurity
+			// and otherwise making it a leaf
+			auto add_candidate = [&candidates, &n_candidates, &is_worse](DecisionTreeNode<T, dataset_x_vars>* node, Histogram&& histogram) {
+				if (node->can_split(node->depth, node->group_size))
+				{
+					double gini_reduction = node->search_split(histogram);
+					if (gini_reduction > 0)
+					{
+						candidates.push_back({ gini_reduction, n_candidates++, node, std::move(histogram) });
+						std::push_heap(candidates.begin(), candidates.end(), is_worse);
+						return;
+					}
+				}
+				node->become_leaf();
+			};
+
+			// split the best candidate until the tree has the maximum number of leaves
+			add_candidate(this, Histogram());
+			int n_leaves = 1;
+			while (!candidates.empty() && n_leaves < context->settings.max_leaves)
+			{
+				std::pop_heap(candidates.begin(), candidates.end(), is_worse);
+				LeafCandidate best = std::move(candidates.back());
+				candidates.pop_back();
+				DecisionTreeNode<T, dataset_x_vars>& node = *best.node;
+
+				// partition the node's group, which becomes a leaf if one side would be empty
+				auto split_point = node.split_group();
+				if (split_point == node.group_begin || split_point == node.group_end)
+				{
+					node.become_leaf();
+					continue;
+				}
+				Histogram left_histogram;
+				Histogram right_histogram;
+				node.create_children(split_point, std::move(best.histogram), left_histogram, right_histogram);
+				n_leaves++;
+				add_candidate(node.left, std::move(left_histogram));
+				add_candidate(node.right, std::move(right_histogram));
+			}
+
+			// the candidates which were not split are leaves
+			for (auto& candidate : candidates)
+			{
+				candidate.node->become_leaf();
+			}
+		}
+
+
+		// trains the tree of which this is the root node one level at a time, keeping a frontier of the open nodes of
+		// the current level and tagging each row of the group with the frontier node it belongs to instead of partitioning
+		// the row indices, so that the histograms of the whole level are built in one streaming pass over each column;
+		// rows go to the same side of each split as when partitioning, so the tree is the one grown depth first
+		void train_level_wise()
+		{
+			// if the root node cannot split, it is the only node
+			if (!can_split(depth, group_size))
+			{
+				become_leaf();
+				return;
+			}
+
+			// put the group's row indices in ascending order, which does not change the tree as no row is partitioned,
+			// so that each pass over the group streams through the columns in order
+			if (!std::is_sorted(group_begin, group_end))
+			{
+				std::sort(group_begin, group_end);
+			}
+
+			// column of class values
+			const uint8_t* labels = context->training_set.label_data();
+
+			// rows of the group which belong to open nodes, in ascending order and with a row appearing as many times as
+			// it does in the group, and the node of the frontier each belongs to
+			std::vector<int> rows(group_begin, group_end);
+			std::vector<int> row_nodes(group_size, 0);
+			// rows from which the level's histograms are built, with the node and class value of each
+			LevelRows build_rows;
+			build_rows.rows = rows;
+			build_rows.nodes = row_nodes;
+			int class_val_sum = 0;
+			for (int row : rows)
+			{
+				build_rows.class_vals.push_back(labels[row]);
+				class_val_sum += labels[row];
+			}
+
+			// open nodes of the current level, their sums of class values and histograms, and for each whether its
+			// histogram is to be built from its rows, or else the parent and sibling from which it is derived
+			std::vector<DecisionTreeNode<T, dataset_x_vars>*> frontier = { this };
+			std::vector<int> class_val_sums = { class_val_sum };
+			std::vector<Histogram> histograms(1);
+			std::vector<uint8_t> build = { 1 };
+			std::vector<std::array<int, 2>> derive_from = { { { -1, -1 } } };
+			std::vector<Histogram> parent_histograms;
+
+			// for each level with open nodes
+			while (!frontier.empty())
+			{
+				// build the histograms of the nodes to be built, then derive their siblings'
+				int n_nodes = static_cast<int>(frontier.size());
+				build_level_histograms(build_rows, build, histograms);
+				for (int node = 0; node < n_nodes; node++)
+				{
+					if (!build[node])
+					{
+						histograms[node] = std::move(parent_histograms[derive_from[node][0]]);
+						const Histogram& sibling_histogram = histograms[derive_from[node][1]];
+						for (size_t i = 0; i < histograms[node].size(); i++)
+						{
+							histograms[node][i][0] -= sibling_histogram[i][0];
+							histograms[node][i][1] -= sibling_histogram[i][1];
+						}
+					}
+				}
+
+				// search for each open node's best split
+				parallel_for(context->thread_pool, n_nodes, [&frontier, &histograms](int node) {
+					frontier[node]->get_best_split_histogram(histograms[node], frontier[node]->choose_split_vars());
+				});
+
+				// tag each row with the child of its node it goes to, where the left child of node i is 2i and the right
+				// 2i + 1, counting the size and summing the class values of each child's group
+				std::vector<int> child_sizes(2 * n_nodes, 0);
+				std::vector<int> child_class_val_sums(2 * n_nodes, 0);
+				for (size_t i = 0; i < rows.size(); i++)
+				{
+					const DecisionTreeNode<T, dataset_x_vars>& frontier_node = *frontier[row_nodes[i]];
+					int child = 2 * row_nodes[i] + !(context->training_set.column_data(frontier_node.split_var)[rows[i]] < frontier_node.split_val);
+					row_nodes[i] = child;
+					++child_sizes[child];
+					child_class_val_sums[child] += labels[rows[i]];
+				}
+
+				// split each node unless one child would be empty, in which case the node becomes a leaf, and add
+				// the children which can split to the next level's frontier, with the rest becoming leaves
+				std::vector<DecisionTreeNode<T, dataset_x_vars>*> next_frontier;
+				std::vector<int> next_class_val_sums;
+				std::vector<uint8_t> next_build;
+				std::vector<std::array<int, 2>> next_derive_from;
+				std::vector<int> child_frontier_indices(2 * n_nodes, -1);
+				for (int node = 0; node < n_nodes; node++)
+				{
+					DecisionTreeNode<T, dataset_x_vars>& frontier_node = *frontier[node];
+					if (child_sizes[2 * node] == 0 || child_sizes[2 * node + 1] == 0)
+					{
+						frontier_node.become_leaf(class_val_sums[node]);
+						continue;
+					}
+					// nodes grown level by level have no range of row indices, only their group's size
+					frontier_node.left = context->nodes.create(frontier_node.depth + 1, group_end, group_end, context);
+					frontier_node.right = context->nodes.create(frontier_node.depth + 1, group_end, group_end, context);
+					frontier_node.left->node_seed = mix_seed(frontier_node.node_seed, 1);
+					frontier_node.right->node_seed = mix_seed(frontier_node.node_seed, 2);
+					std::array<DecisionTreeNode<T, dataset_x_vars>*, 2> children = { { frontier_node.left, frontier_node.right } };
+					for (int side = 0; side < 2; side++)
+					{
+						int child = 2 * node + side;
+						children[side]->group_size = child_sizes[child];
+						if (can_split(children[side]->depth, children[side]->group_size))
+						{
+							child_frontier_indices[child] = static_cast<int>(next_frontier.size());
+							next_frontier.push_back(children[side]);
+							next_class_val_sums.push_back(child_class_val_sums[child]);
+						}
+						else
+						{
+							children[side]->become_leaf(child_class_val_sums[child]);
+						}
+					}
+					// if both children are open, only the smaller's histogram is built and its sibling's is derived
+					// by subtracting it from this node's, otherwise the open child's histogram is built
+					int left_index = child_frontier_indices[2 * node];
+					int right_index = child_frontier_indices[2 * node + 1];
+					if (left_index >= 0 && right_index >= 0)
+					{
+						bool left_is_smaller = child_sizes[2 * node] <= child_sizes[2 * node + 1];
+						next_build.push_back(left_is_smaller);
+						next_build.push_back(!left_is_smaller);
+						next_derive_from.push_back({ { node, right_index } });
+						next_derive_from.push_back({ { node, left_index } });
+					}
+					else if (left_index >= 0 || right_index >= 0)
+					{
+						next_build.push_back(1);
+						next_derive_from.push_back({ { -1, -1 } });
+					}
+				}
+
+				// retag each row with its node's index in the next level's frontier, dropping rows whose node is a leaf,
+				// and gather the rows from which the next level's histograms are built
+				size_t n_open_rows = 0;
+				build_rows.clear();
+				for (size_t i = 0; i < rows.size(); i++)
+				{
+					int node = child_frontier_indices[row_nodes[i]];
+					if (node >= 0)
+					{
+						rows[n_open_rows] = rows[i];
+						row_nodes[n_open_rows] = node;
+						n_open_rows++;
+						if (next_build[node])
+						{
+							build_rows.rows.push_back(rows[i]);
+							build_rows.nodes.push_back(node);
+							build_rows.class_vals.push_back(labels[rows[i]]);
+						}
+					}
+				}
+				rows.resize(n_open_rows);
+				row_nodes.resize(n_open_rows);
+
+				// move on to the next level, keeping this level's histograms from which to derive the next's
+				parent_histograms = std::move(histograms);
+				histograms.assign(next_frontier.size(), Histogram());
+				frontier = std::move(next_frontier);
+				class_val_sums = std::move(next_class_val_sums);
+				build = std::move(next_build);
+				derive_from = std::move(next_derive_from);
+			}
+		}
+
+
+		// returns whether the node is a leaf node
+		bool is_leaf() const
+		{
+			return class_prediction >= 0;
+		}
+
+
+		// returns the split variable of a node which is not a leaf
+		int get_split_var() const
+		{
+			return split_var;
+		}
+
+
+		// returns the split value of a node which is not a leaf
+		T get_split_val() const
+		{
+			return split_val;
+		}
+
+
+		// returns the class prediction of a leaf node
+		int get_class_prediction() const
+		{
+			return class_prediction;
+		}
+
+
+		// returns a pointer to the left child node of a node which is not a leaf
+		const DecisionTreeNode<T, dataset_x_vars>* get_left() const
+		{
+			return left;
+		}
+
+
+		// returns a pointer to the right child node of a node which is not a leaf
+		const DecisionTreeNode<T, dataset_x_vars>* get_right() const
+		{
+			return right;
+		}
+
+
+		// returns a modifiable pointer to the left child node of a node which is not a leaf
+		DecisionTreeNode<T, dataset_x_vars>* get_left()
+		{
+			return left;
+		}
+
+
+		// returns a modifiable pointer to the right child node of a node which is not a leaf
+		DecisionTreeNode<T, dataset_x_vars>* get_right()
+		{
+			return right;
+		}
+
+
+		// turns a trained node into a leaf with the given class prediction, detaching its subtree,
+		// whose nodes are freed with the rest of the tree's arena
+		void collapse(int prediction)
+		{
+			left = nullptr;
+			right = nullptr;
+			class_prediction = prediction;
+		}
+
+
 		// method template for making a prediction based on a sample
-		template<int sample_length>
-		int predict(const std::array<T, sample_length>& sample)
+		template<typename SampleType>
+		int predict(const SampleType& sample) const
 		{
 			// if node is leaf node, return prediction
 			if (class_prediction >= 0)
@@ -122,10 +474,160 @@ namespace MLComparison
 
 	private:
 
+		// struct for a candidate split point, recording where it was first encountered so that the best
+		// of the candidates found by searches run in parallel is the one a serial search would have chosen
+		struct SplitCandidate
+		{
+			// gini index of the split
+			double gini_index;
+			// split variable and value
+			int split_var;
+			T split_val;
+			// position in the group of the first row with the split value, or for histogram
+			// searches the index of the bin the split value bounds
+			int position;
+		};
+
+
+		// struct for a leaf of a tree grown best first which may be split, with the reduction in Gini impurity its best
+		// split would make, the order in which it was found, which breaks ties, and its class histogram if one is used
+		struct LeafCandidate
+		{
+			double gini_reduction;
+			int order;
+			DecisionTreeNode<T, dataset_x_vars>* node;
+			Histogram histogram;
+		};
+
+
+		// struct for the rows from which the histograms of a level of a tree grown level by level are built, with the
+		// node of the level each belongs to and its class value, stored as parallel arrays which are streamed through
+		struct LevelRows
+		{
+			std::vector<int> rows;
+			std::vector<int> nodes;
+			std::vector<uint8_t> class_vals;
+
+
+			// removes all the rows
+			void clear()
+			{
+				rows.clear();
+				nodes.clear();
+				class_vals.clear();
+			}
+		};
+
+
 		// default constructor does not make sense for this class, so it is kept private and without definition
 		DecisionTreeNode();
 
 
+		// searches for the node's best split point using the configured split method, building the class histogram of its
+		// group first if the histogram split method is used and its parent has not derived it, and returns the reduction in
+		// Gini impurity the split makes, weighted by group size
+		double search_split(Histogram& histogram)
+		{
+			// choose the variables on which to consider splitting
+			std::vector<int> split_vars = choose_split_vars();
+			// determine best split variable and value using the configured split method
+			if (context->settings.split_method == SplitMethod::sorted_sweep)
+			{
+				get_best_split_sorted_sweep(split_vars);
+			}
+			else if (context->settings.split_method == SplitMethod::histogram)
+			{
+				if (histogram.empty())
+				{
+					histogram = build_histogram(group_begin, group_end);
+				}
+				get_best_split_histogram(histogram, split_vars);
+			}
+			else if (context->settings.split_method == SplitMethod::random_thresholds)
+			{
+				get_best_split_random_thresholds(split_vars);
+			}
+			else
+			{
+				get_best_split(split_vars);
+			}
+
+			// the impurity of the group is the Gini index of a split which leaves all of it on one side
+			const uint8_t* labels = context->training_set.label_data();
+			double class_val_sum = 0;
+			for (auto it = group_begin; it < group_end; ++it)
+			{
+				class_val_sum += labels[*it];
+			}
+			double impurity = calculate_gini_index({ { static_cast<double>(group_size), 0 } }, { { class_val_sum, 0 } });
+			return group_size * (impurity - split_gini_index);
+		}
+
+
+		// creates the node's child nodes once its group has been partitioned at the given split point, keeping the
+		// workspace's sorted lists in step with the row indices, and derives the children's class histograms if they
+		// will be needed, building only the smaller child's from its rows and subtracting it from this node's
+		void create_children(std::vector<int>::iterator split_point, Histogram&& histogram, Histogram& left_histogram, Histogram& right_histogram)
+		{
+			// keep the workspace's sorted lists in step with the partitioned row indices
+			if (context->settings.split_method == SplitMethod::sorted_sweep)
+			{
+				context->workspace->partition_sorted_indices(group_begin, split_point, group_end);
+			}
+			left = context->nodes.create(depth + 1, group_begin, split_point, context);
+			right = context->nodes.create(depth + 1, split_point, group_end, context);
+			left->node_seed = mix_seed(node_seed, 1);
+			right->node_seed = mix_seed(node_seed, 2);
+			if (context->settings.split_method == SplitMethod::histogram && can_split(depth + 1, std::max(left->group_size, right->group_size)))
+			{
+				bool left_is_smaller = left->group_size <= right->group_size;
+				Histogram& smaller_histogram = left_is_smaller ? left_histogram : right_histogram;
+				Histogram& larger_histogram = left_is_smaller ? right_histogram : left_histogram;
+				smaller_histogram = left_is_smaller ? build_histogram(group_begin, split_point) : build_histogram(split_point, group_end);
+				larger_histogram = std::move(histogram);
+				for (size_t i = 0; i < larger_histogram.size(); i++)
+				{
+					larger_histogram[i][0] -= smaller_histogram[i][0];
+					larger_histogram[i][1] -= smaller_histogram[i][1];
+				}
+			}
+		}
+
+
+		// returns the variables, in ascending order, on which the node considers splitting, which are all those to
+		// use unless the settings limit their number, when a random subset is drawn with the node's own seed,
+		// so that the choice does not depend on the order in which nodes are trained
+		std::vector<int> choose_split_vars() const
+		{
+			// start with all the variables to use
+			std::vector<int> split_vars(context->x_vars_to_use);
+			for (int col = 0; col < context->x_vars_to_use; col++)
+			{
+				split_vars[col] = col;
+			}
+			// if fewer are to be considered, move a random subset to the front with a partial shuffle and keep it
+			if (context->settings.max_features > 0 && context->settings.max_features < context->x_vars_to_use)
+			{
+				std::mt19937_64 rng(node_seed);
+				for (int i = 0; i < context->settings.max_features; i++)
+				{
+					std::uniform_int_distribution<int> dist(i, context->x_vars_to_use - 1);
+					std::swap(split_vars[i], split_vars[dist(rng)]);
+				}
+				split_vars.resize(context->settings.max_features);
+				std::sort(split_vars.begin(), split_vars.end());
+			}
+			return split_vars;
+		}
+
+
+		// returns whether a node of the given depth and group size is allowed to split
+		bool can_split(int node_depth, int node_group_size) const
+		{
+			return node_depth < context->settings.max_depth && node_group_size >= context->settings.min_split_group_size;
+		}
+
+
 		// calculates the Gini index of a split point defined by a split variable and value
 		double calculate_gini_index(int split_variable, T split_value)
 		{
@@ -134,20 +636,29 @@ namespace MLComparison
 			// array of subgroup class value sums
 			std::array<double, 2> subgroup_class_val_sums = {};
 			
+			// columns of the split variable and class values
+			const T* column = context->training_set.column_data(split_variable);
+			const uint8_t* labels = context->training_set.label_data();
 			// subgroup current row belongs in
 			uint8_t row_subgroup = 0;
 			// for each row in the group
 			for (auto it = group_begin; it < group_end; ++it)
 			{
-				// get a reference to the current row
-				const auto& row = training_set->at(*it);
 				// determine which subgroup the row belongs in
-				row_subgroup = row[split_variable] >= split_value;
+				row_subgroup = column[*it] >= split_value;
 				// increment the revelvant subgroup size and class value sum appropriately
 				++subgroup_sizes[row_subgroup];
-				subgroup_class_val_sums[row_subgroup] += row[dataset_x_vars];
+				subgroup_class_val_sums[row_subgroup] += labels[*it];
 			}
 
+			// return the Gini index of the resulting subgroups
+			return calculate_gini_index(subgroup_sizes, subgroup_class_val_sums);
+		}
+
+
+		// calculates the Gini index of a split point from the sizes and class value sums of the two subgroups it creates
+		double calculate_gini_index(const std::array<double, 2>& subgroup_sizes, const std::array<double, 2>& subgroup_class_val_sums) const
+		{
 			// subgroup sizes as proportions
 			std::array<double, 2> subgroup_size_proportions;
 			subgroup_size_proportions[0] = subgroup_sizes[0] / group_size;
@@ -178,45 +689,117 @@ namespace MLComparison
 		}
 
 
+		// returns the candidate split point with which a search starts, which any split point
+		// with a lower gini index replaces and no split point with an equal one does
+		static SplitCandidate initial_split_candidate()
+		{
+			return { 0.5, 0, 0, -1 };
+		}
+
+
+		// returns whether a candidate split point is better than another, i.e. it has a lower gini index
+		// or an equal one but was encountered first, at an earlier position or at the same position for an
+		// earlier variable, which makes the best of a set of candidates independent of the order they were found
+		static bool is_better(const SplitCandidate& candidate, const SplitCandidate& best)
+		{
+			return candidate.gini_index < best.gini_index || (candidate.gini_index == best.gini_index &&
+				(candidate.position < best.position || (candidate.position == best.position && candidate.split_var < best.split_var)));
+		}
+
+
+		// set split variable and value fields from the best candidate split point
+		void set_split(const SplitCandidate& best)
+		{
+			split_var = best.split_var;
+			split_val = best.split_val;
+			split_gini_index = best.gini_index;
+		}
+
+
+		// returns whether the node's split search is large enough to be divided into tasks on the thread pool
+		bool use_parallel_split_search() const
+		{
+			return context->thread_pool != nullptr && group_size >= context->settings.parallel_split_search_min_group_size;
+		}
+
+
+		// returns the number of tasks into which to divide a parallel split search, a few per thread
+		// so that the threads stay busy when tasks take different times, but with no fewer than 64 rows each
+		int n_split_search_tasks() const
+		{
+			return std::max(1, std::min(static_cast<int>(context->thread_pool->size() + 1) * 4, group_size / 64));
+		}
+
+
 		// find the split point (variable and value) in this node's training group which has
 		// the lowest gini index, and set the node's split variable and value accordingly
-		void get_best_split()
+		void get_best_split(const std::vector<int>& split_vars)
+		{
+			// best split point found
+			SplitCandidate best = initial_split_candidate();
+
+			// if the search is large enough, divide the group into chunks searched in parallel
+			// and reduce their best split points to the one which would have been found first
+			if (use_parallel_split_search())
+			{
+				int n_chunks = n_split_search_tasks();
+				std::vector<SplitCandidate> chunk_bests(n_chunks);
+				parallel_for(context->thread_pool, n_chunks, [this, n_chunks, &split_vars, &chunk_bests](int chunk) {
+					chunk_bests[chunk] = get_best_split_exhaustive(group_begin + group_size * chunk / n_chunks,
+						group_begin + group_size * (chunk + 1) / n_chunks, split_vars);
+				});
+				for (const auto& chunk_best : chunk_bests)
+				{
+					if (is_better(chunk_best, best))
+					{
+						best = chunk_best;
+					}
+				}
+			}
+			// otherwise, search the whole group
+			else
+			{
+				best = get_best_split_exhaustive(group_begin, group_end, split_vars);
+			}
+
+			// set split variable and value fields once the best are found
+			set_split(best);
+		}
+
+
+		// returns the split point with the lowest gini index among the values of the given variables of the rows
+		// in the given range of the node's group, by calculating the gini index of each over the whole group
+		SplitCandidate get_best_split_exhaustive(std::vector<int>::iterator range_begin, std::vector<int>::iterator range_end,
+			const std::vector<int>& split_vars)
 		{
 			// split value being tested
 			T current_val = 0;
 			// gini index of current split point
 			double current_gini_index = 0;
 
-			// best gini index found
-			double best_gini_index = 0.5;
-			// split value associated with best gini index
-			double best_val = 0;
-			// split variable associated with best gini index
-			int best_var = 0;
+			// best split point found
+			SplitCandidate best = initial_split_candidate();
 
 			// whether perfect gini index has been found
 			bool done = false;
 
-			// for each row index of the current group
-			for (auto it = group_begin; it < group_end && !done; ++it)
+			// for each row index of the range
+			for (auto it = range_begin; it < range_end && !done; ++it)
 			{
-				// get reference to current row
-				const auto& row = training_set->at(*it);
 				// for each field to use in the current row
-				for (int col = 0; col < x_vars_to_use && !done; col++)
+				for (auto var_it = split_vars.begin(); var_it < split_vars.end() && !done; ++var_it)
 				{
+					int col = *var_it;
 					// get the field's value
-					current_val = row[col];
+					current_val = context->training_set.column_data(col)[*it];
 					// calculate Gini index of split at current row & col
 					current_gini_index = calculate_gini_index(col, current_val);
 					// update best if necessary
-					if (current_gini_index < best_gini_index)
+					if (current_gini_index < best.gini_index)
 					{
-						best_gini_index = current_gini_index;
-						best_val = current_val;
-						best_var = col;
+						best = { current_gini_index, col, current_val, static_cast<int>(std::distance(group_begin, it)) };
 						// stop if perfect Gini score has been found
-						if (best_gini_index == 0)
+						if (best.gini_index == 0)
 						{
 							done = true;
 						}
@@ -224,9 +807,374 @@ namespace MLComparison
 				}
 			}
 
+			// return the best split point
+			return best;
+		}
+
+
+		// find the same split point as get_best_split, but by sweeping running class counts along the workspace's
+		// lists of the group's row indices sorted by each variable, which costs O(n * d) rather than O(n^2 * d);
+		// ties are broken by the position of a value's first occurrence in the group, then by variable,
+		// which is the order in which get_best_split encounters them, so both methods build identical trees
+		void get_best_split_sorted_sweep(const std::vector<int>& split_vars)
+		{
+			// record the position of each row within the group, iterating backwards so
+			// that the first occurrence is recorded for any row which appears more than once
+			for (auto it = group_end; it != group_begin;)
+			{
+				--it;
+				context->workspace->set_group_position(*it, static_cast<int>(std::distance(group_begin, it)));
+			}
+
+			// get sum of class values in group
+			const uint8_t* labels = context->training_set.label_data();
+			double group_class_val_sum = 0;
+			for (auto it = group_begin; it < group_end; ++it)
+			{
+				group_class_val_sum += labels[*it];
+			}
+
+			// range of the group within the sorted lists
+			auto offset = context->workspace->get_offset(group_begin);
+
+			// number of chunks into which each sorted list is divided, which are swept in parallel if large enough
+			int n_chunks = use_parallel_split_search() ? n_split_search_tasks() : 1;
+			// number of variables to sweep
+			int n_split_vars = static_cast<int>(split_vars.size());
+			// the start of each chunk within the group, moved forward so that no run of equal values is divided
+			std::vector<int> chunk_starts(n_split_vars * (n_chunks + 1));
+			for (int var = 0; var < n_split_vars; var++)
+			{
+				const T* column = context->training_set.column_data(split_vars[var]);
+				auto sorted_it = context->workspace->sorted_begin(split_vars[var], offset);
+				for (int chunk = 0; chunk <= n_chunks; chunk++)
+				{
+					int start = std::max(group_size * chunk / n_chunks, chunk > 0 ? chunk_starts[var * (n_chunks + 1) + chunk - 1] : 0);
+					while (start > 0 && start < group_size && column[sorted_it[start]] == column[sorted_it[start - 1]])
+					{
+						start++;
+					}
+					chunk_starts[var * (n_chunks + 1) + chunk] = start;
+				}
+			}
+
+			// sizes and class value sums of the rows in each chunk
+			std::vector<std::array<double, 2>> chunk_counts(n_split_vars * n_chunks, { { 0, 0 } });
+			if (n_chunks > 1)
+			{
+				parallel_for(context->thread_pool, n_split_vars * n_chunks, [this, n_chunks, offset, labels, &split_vars, &chunk_starts, &chunk_counts](int task) {
+					int var = task / n_chunks;
+					auto sorted_it = context->workspace->sorted_begin(split_vars[var], offset);
+					for (int i = chunk_starts[task + var]; i < chunk_starts[task + var + 1]; i++)
+					{
+						++chunk_counts[task][0];
+						chunk_counts[task][1] += labels[sorted_it[i]];
+					}
+				});
+			}
+
+			// sweep each chunk of each sorted list, starting with the sizes and class value sums of the
+			// subgroups either side of the chunk's start, which are accumulated over the chunks before it
+			std::vector<SplitCandidate> chunk_bests(n_split_vars * n_chunks);
+			parallel_for(use_parallel_split_search() ? context->thread_pool : nullptr, n_split_vars * n_chunks,
+				[this, n_chunks, offset, group_class_val_sum, &split_vars, &chunk_starts, &chunk_counts, &chunk_bests](int task) {
+					int var = task / n_chunks;
+					std::array<double, 2> subgroup_sizes = { 0, static_cast<double>(group_size) };
+					std::array<double, 2> subgroup_class_val_sums = { 0, group_class_val_sum };
+					for (int chunk = var * n_chunks; chunk < task; chunk++)
+					{
+						subgroup_sizes[0] += chunk_counts[chunk][0];
+						subgroup_sizes[1] -= chunk_counts[chunk][0];
+						subgroup_class_val_sums[0] += chunk_counts[chunk][1];
+						subgroup_class_val_sums[1] -= chunk_counts[chunk][1];
+					}
+					auto sorted_it = context->workspace->sorted_begin(split_vars[var], offset);
+					chunk_bests[task] = sweep_sorted_indices(split_vars[var], sorted_it + chunk_starts[task + var], sorted_it + chunk_starts[task + var + 1],
+						subgroup_sizes, subgroup_class_val_sums);
+				}
+			);
+
+			// the best split point is the best of the chunks' best split points
+			SplitCandidate best = initial_split_candidate();
+			for (const auto& chunk_best : chunk_bests)
+			{
+				if (is_better(chunk_best, best))
+				{
+					best = chunk_best;
+				}
+			}
+
+			// set split variable and value fields once the best are found
+			set_split(best);
+		}
+
+
+		// returns the best split point among the values in a range of a sorted list of the group's row indices,
+		// given the sizes and class value sums of the subgroups either side of the start of the range
+		SplitCandidate sweep_sorted_indices(int col, std::vector<int>::iterator range_begin, std::vector<int>::iterator range_end,
+			std::array<double, 2> subgroup_sizes, std::array<double, 2> subgroup_class_val_sums)
+		{
+			// columns of the current variable and class values
+			const T* column = context->training_set.column_data(col);
+			const uint8_t* labels = context->training_set.label_data();
+
+			// best split point found
+			SplitCandidate best = initial_split_candidate();
+
+			// for each run of equal values in the range
+			for (auto it = range_begin; it < range_end;)
+			{
+				// the run's value is a candidate split value, with all rows before the run in the left subgroup
+				T current_val = column[*it];
+				double current_gini_index = calculate_gini_index(subgroup_sizes, subgroup_class_val_sums);
+
+				// move the run into the left subgroup, noting where its value first occurs in the group
+				int first_position = std::numeric_limits<int>::max();
+				for (; it < range_end && column[*it] == current_val; ++it)
+				{
+					double class_val = labels[*it];
+					++subgroup_sizes[0];
+					--subgroup_sizes[1];
+					subgroup_class_val_sums[0] += class_val;
+					subgroup_class_val_sums[1] -= class_val;
+					first_position = std::min(first_position, context->workspace->get_group_position(*it));
+				}
+
+				// update best if the split is better, or equally good but encountered earlier by get_best_split
+				SplitCandidate candidate = { current_gini_index, col, current_val, first_position };
+				if (is_better(candidate, best))
+				{
+					best = candidate;
+				}
+			}
+
+			// return the best split point
+			return best;
+		}
+
+
+		// find the split point with the lowest gini index among a few thresholds per variable drawn at random between
+		// the group's minimum and maximum values of the variable, and set the node's split variable and value accordingly;
+		// the random numbers are drawn up front from a stream of the node's seed, so the split does not depend on the
+		// number of threads
+		void get_best_split_random_thresholds(const std::vector<int>& split_vars)
+		{
+			// draw the position of each threshold between the minimum and maximum of its variable
+			int n_thresholds = std::max(1, context->settings.n_random_thresholds);
+			int n_split_vars = static_cast<int>(split_vars.size());
+			std::vector<double> threshold_positions(n_split_vars * n_thresholds);
+			std::mt19937_64 rng(mix_seed(node_seed, 3));
+			std::uniform_real_distribution<double> dist(0.0, 1.0);
+			for (auto& position : threshold_positions)
+			{
+				position = dist(rng);
+			}
+
+			// best split point of each variable, searched in parallel if the search is large enough
+			std::vector<SplitCandidate> var_bests(n_split_vars);
+			parallel_for(use_parallel_split_search() ? context->thread_pool : nullptr, n_split_vars,
+				[this, n_thresholds, &split_vars, &threshold_positions, &var_bests](int var) {
+					var_bests[var] = scan_random_thresholds(split_vars[var], threshold_positions.data() + var * n_thresholds, n_thresholds);
+				}
+			);
+
+			// the best split point is the best of the variables' best split points
+			SplitCandidate best = initial_split_candidate();
+			for (const auto& var_best : var_bests)
+			{
+				if (is_better(var_best, best))
+				{
+					best = var_best;
+				}
+			}
+
+			// set split variable and value fields once the best are found
+			set_split(best);
+		}
+
+
+		// returns the best split point among thresholds of a variable at the given positions between the group's
+		// minimum and maximum values of it, where the position of a split point is the index of its threshold
+		SplitCandidate scan_random_thresholds(int col, const double* positions, int n_thresholds)
+		{
+			// best split point found
+			SplitCandidate best = initial_split_candidate();
+
+			// find the range of the variable's values in the group, which cannot be split if they are all equal
+			const T* column = context->training_set.column_data(col);
+			const uint8_t* labels = context->training_set.label_data();
+			T min_val = column[*group_begin];
+			T max_val = min_val;
+			double class_val_sum = 0;
+			for (auto it = group_begin; it < group_end; ++it)
+			{
+				min_val = std::min(min_val, column[*it]);
+				max_val = std::max(max_val, column[*it]);
+				class_val_sum += labels[*it];
+			}
+			if (!(min_val < max_val))
+			{
+				return best;
+			}
+
+			// place the thresholds and count the rows below each with their class values in one pass over the group
+			std::vector<T> thresholds(n_thresholds);
+			for (int i = 0; i < n_thresholds; i++)
+			{
+				thresholds[i] = static_cast<T>(min_val + positions[i] * (max_val - min_val));
+			}
+			std::vector<std::array<double, 2>> below(n_thresholds, { { 0, 0 } });
+			for (auto it = group_begin; it < group_end; ++it)
+			{
+				T value = column[*it];
+				double class_val = labels[*it];
+				for (int i = 0; i < n_thresholds; i++)
+				{
+					bool is_below = value < thresholds[i];
+					below[i][0] += is_below;
+					below[i][1] += is_below * class_val;
+				}
+			}
+
+			// evaluate the split at each threshold which leaves neither subgroup empty
+			for (int i = 0; i < n_thresholds; i++)
+			{
+				if (below[i][0] == 0 || below[i][0] == group_size)
+				{
+					continue;
+				}
+				std::array<double, 2> subgroup_sizes = { below[i][0], group_size - below[i][0] };
+				std::array<double, 2> subgroup_class_val_sums = { below[i][1], class_val_sum - below[i][1] };
+				SplitCandidate candidate = { calculate_gini_index(subgroup_sizes, subgroup_class_val_sums), col, thresholds[i], i };
+				if (is_better(candidate, best))
+				{
+					best = candidate;
+				}
+			}
+
+			// return the best split point
+			return best;
+		}
+
+
+		// builds the class histogram of the rows in the given range of row indices from their bin codes,
+		// with the variables' histograms built in parallel if the node's split search is large enough
+		Histogram build_histogram(std::vector<int>::iterator range_begin, std::vector<int>::iterator range_end)
+		{
+			// histogram holding a row count and class value sum for each bin of each variable to use
+			Histogram histogram(context->x_vars_to_use * max_bins, { { 0, 0 } });
+			// column of class values
+			const uint8_t* labels = context->training_set.label_data();
+			// for each variable to use, streaming through its column of bin codes
+			parallel_for(use_parallel_split_search() ? context->thread_pool : nullptr, context->x_vars_to_use,
+				[this, range_begin, range_end, labels, &histogram](int col) {
+					const uint8_t* codes = context->training_set.binned_column_data(col);
+					auto* col_histogram = histogram.data() + col * max_bins;
+					// add each row in the range to the bin it falls into
+					for (auto it = range_begin; it < range_end; ++it)
+					{
+						auto& bin = col_histogram[codes[*it]];
+						++bin[0];
+						bin[1] += labels[*it];
+					}
+				}
+			);
+			return histogram;
+		}
+
+
+		// builds the class histograms of the nodes of a level of the tree which are to be built from their rows, given
+		// those rows, in one pass over each variable's column of bin codes, with the variables divided between the threads
+		void build_level_histograms(const LevelRows& build_rows, const std::vector<uint8_t>& build, std::vector<Histogram>& histograms)
+		{
+			// allocate the histograms to be built
+			for (size_t node = 0; node < histograms.size(); node++)
+			{
+				if (build[node])
+				{
+					histograms[node].assign(context->x_vars_to_use * max_bins, { { 0, 0 } });
+				}
+			}
+			// for each variable to use, streaming through its column of bin codes once for the whole level
+			parallel_for(context->thread_pool, context->x_vars_to_use, [this, &build_rows, &histograms](int col) {
+				const uint8_t* codes = context->training_set.binned_column_data(col);
+				// add each row to the bin of its node's histogram it falls into
+				for (size_t i = 0; i < build_rows.rows.size(); i++)
+				{
+					auto& bin = histograms[build_rows.nodes[i]][col * max_bins + codes[build_rows.rows[i]]];
+					++bin[0];
+					bin[1] += build_rows.class_vals[i];
+				}
+			});
+		}
+
+
+		// find the split point with the lowest gini index among the lower bounds of the bins of each
+		// variable, using the group's class histogram, and set the node's split variable and value accordingly
+		void get_best_split_histogram(const Histogram& histogram, const std::vector<int>& split_vars)
+		{
+			// best split point of each variable, scanned in parallel if the search is large enough
+			std::vector<SplitCandidate> col_bests(split_vars.size());
+			parallel_for(use_parallel_split_search() ? context->thread_pool : nullptr, static_cast<int>(split_vars.size()),
+				[this, &histogram, &split_vars, &col_bests](int var) {
+					col_bests[var] = scan_histogram(histogram, split_vars[var]);
+				}
+			);
+
+			// the best split point is the best of the variables' best split points
+			SplitCandidate best = initial_split_candidate();
+			for (const auto& col_best : col_bests)
+			{
+				if (is_better(col_best, best))
+				{
+					best = col_best;
+				}
+			}
+
 			// set split variable and value fields once the best are found
-			split_var = best_var;
-			split_val = best_val;
+			set_split(best);
+		}
+
+
+		// returns the best split point among the lower bounds of the bins of a variable, using the group's class
+		// histogram, where the position of a split point is its variable and bin so that earlier ones win ties
+		SplitCandidate scan_histogram(const Histogram& histogram, int col)
+		{
+			// best split point found
+			SplitCandidate best = initial_split_candidate();
+
+			// sizes and class value sums of the subgroups on either side of the current bin's lower bound
+			std::array<double, 2> subgroup_sizes = { 0, static_cast<double>(group_size) };
+			std::array<double, 2> subgroup_class_val_sums = {};
+			for (int bin = 0; bin < context->training_set.get_n_bins(col); bin++)
+			{
+				subgroup_class_val_sums[1] += histogram[col * max_bins + bin][1];
+			}
+
+			// for each bin after the first, move the previous bin into the left subgroup and evaluate a split
+			// at the bin's lower bound, skipping bins which would leave either subgroup empty
+			for (int bin = 1; bin < context->training_set.get_n_bins(col); bin++)
+			{
+				const auto& previous_bin = histogram[col * max_bins + bin - 1];
+				subgroup_sizes[0] += previous_bin[0];
+				subgroup_sizes[1] -= previous_bin[0];
+				subgroup_class_val_sums[0] += previous_bin[1];
+				subgroup_class_val_sums[1] -= previous_bin[1];
+				if (subgroup_sizes[0] == 0 || subgroup_sizes[1] == 0)
+				{
+					continue;
+				}
+
+				// update best if necessary
+				double current_gini_index = calculate_gini_index(subgroup_sizes, subgroup_class_val_sums);
+				if (current_gini_index < best.gini_index)
+				{
+					best = { current_gini_index, col, context->training_set.get_bin_threshold(col, bin), col * max_bins + bin };
+				}
+			}
+
+			// return the best split point
+			return best;
 		}
 
 
@@ -234,10 +1182,12 @@ namespace MLComparison
 		// an iterator pointing to the split point (first row index of the second group)
 		auto split_group()
 		{
+			// column of the split variable
+			const T* column = context->training_set.column_data(split_var);
 			// sort group based on split variable and value and return iterator pointing to split point (first element of second group)
 			return std::partition(group_begin, group_end,
-				[this](int i) -> bool { 
-					return training_set->at(i)[split_var] < split_val;
+				[this, column](int i) -> bool { 
+					return column[i] < split_val;
 				}
 			);
 		}
@@ -247,13 +1197,21 @@ namespace MLComparison
 		void become_leaf()
 		{
 			// get sum of class values in group
+			const uint8_t* labels = context->training_set.label_data();
 			int sum = 0;
 			for (auto it = group_begin; it < group_end; ++it)
 			{
-				sum += training_set->at(*it)[dataset_x_vars];
+				sum += labels[*it];
 			}
+			become_leaf(sum);
+		}
+
+
+		// set the leaf prediction value based on the sum of class values of the node's group
+		void become_leaf(int class_val_sum)
+		{
 			// set leaf class prediction based on whichever class is more prevalent
-			class_prediction = (sum > group_size / 2) ? 1 : 0;
+			class_prediction = (class_val_sum > group_size / 2) ? 1 : 0;
 		}
 
 
@@ -262,19 +1220,18 @@ namespace MLComparison
 		T split_val = -1;
 		// class prediction if the node is a leaf
 		int class_prediction = -1;
+		// Gini index of the best split point found for the node
+		double split_gini_index = 0.5;
 
 		// depth of node in tree
 		int depth;
 
-		// pointers to left and right child nodes
-		std::unique_ptr<DecisionTreeNode<T, dataset_x_vars>> left = nullptr;
-		std::unique_ptr<DecisionTreeNode<T, dataset_x_vars>> right = nullptr;
-
-		// pointer to the dataset on which to train
-		std::shared_ptr<DecisionTreeDataset<T, dataset_x_vars>> training_set;
+		// pointers to left and right child nodes, which are owned by the tree's node arena
+		DecisionTreeNode<T, dataset_x_vars>* left = nullptr;
+		DecisionTreeNode<T, dataset_x_vars>* right = nullptr;
 
-		// number of dependent variables in the dataset to use
-		int x_vars_to_use;
+		// pointer to the context of the tree
+		DecisionTreeContext<T, dataset_x_vars>* context;
 
 		// iterators pointing to the elements in the training set's vector of row indices
 		// which define the start and end of the group of samples on which to train
@@ -283,5 +1240,57 @@ namespace MLComparison
 
 		// number of rows in the node's training group
 		int group_size = 0;
+
+		// seed from which the node draws its random choices
+		uint64_t node_seed = 0;
+
+		// maximum number of bins per variable in a class histogram, as bin codes are 8-bit
+		static const int max_bins = 256;
+	};
+
+
+	// struct template for the context of a decision tree, which holds what all its nodes share and owns the nodes
+	// themselves in an arena, so that nodes hold a single pointer to it rather than copies of the settings and
+	// reference-counted pointers, and the whole tree is freed at once when the context is destroyed
+	template<typename T, int dataset_x_vars>
+	struct DecisionTreeContext
+	{
+		// constructor which takes the training dataset, which must outlive the tree's training, the number of
+		// training set independent variables to use, the training settings, for the sorted sweep split method a
+		// pointer to the tree's workspace, and for parallel training a pointer to the thread pool on which to train subtrees
+		DecisionTreeContext(DecisionTreeDataset<T, dataset_x_vars>& training_dataset, int dataset_x_vars_to_use = dataset_x_vars,
+			const DecisionTreeSettings& tree_settings = DecisionTreeSettings(),
+			DecisionTreeWorkspace<T, dataset_x_vars>* tree_workspace = nullptr,
+			WorkStealingThreadPool* training_thread_pool = nullptr) :
+			training_set(training_dataset), x_vars_to_use(dataset_x_vars_to_use),
+			settings(tree_settings), workspace(tree_workspace), thread_pool(training_thread_pool)
+		{
+		}
+
+
+		// creates the root node of the tree with the given group of training row indices
+		DecisionTreeNode<T, dataset_x_vars>* create_root(std::vector<int>::iterator group_begin, std::vector<int>::iterator group_end)
+		{
+			return nodes.create(0, group_begin, group_end, this);
+		}
+
+
+		// dataset on which to train
+		DecisionTreeDataset<T, dataset_x_vars>& training_set;
+
+		// number of dependent variables in the dataset to use
+		int x_vars_to_use;
+
+		// settings which control how the tree is trained
+		DecisionTreeSettings settings;
+
+		// pointer to the tree's sorted row index lists, used by the sorted sweep split method while training
+		DecisionTreeWorkspace<T, dataset_x_vars>* workspace;
+
+		// pointer to the thread pool on which subtrees are trained, or null to train serially
+		WorkStealingThreadPool* thread_pool;
+
+		// arena which owns the nodes of the tree
+		NodeArena<DecisionTreeNode<T, dataset_x_vars>> nodes;
 	};
 }
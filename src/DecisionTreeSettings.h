@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstdint>
+
+
+namespace MLComparison
+{
+	// methods a decision tree node can use to search for its best split point
+	enum class SplitMethod
+	{
+		// evaluates the Gini index of every value of every variable in the group by rescanning the group, O(n^2 * d) per node
+		exhaustive,
+		// sweeps running class counts over per-feature row index lists which are sorted once, O(n * d) per node
+		sorted_sweep,
+		// scans class histograms of each variable's quantile bins, with one child's histogram derived
+		// by subtracting its sibling's from its parent's, O(n * d) per node with only integer counting
+		histogram,
+		// evaluates a few thresholds per variable drawn at random between the group's minimum and maximum values,
+		// as in extremely randomized trees, O(n * d * k) per node for k thresholds per variable
+		random_thresholds
+	};
+
+
+	// orders in which a decision tree's nodes can be grown
+	enum class GrowthPolicy
+	{
+		// trains each node's subtrees recursively, partitioning the row indices of its group between its children
+		depth_first,
+		// trains all the open nodes of each level together, tagging each row with the node it belongs to rather
+		// than partitioning the row indices, and building the level's histograms in one streaming pass over each
+		// column, which always uses the histogram split method
+		level_wise,
+		// keeps a priority queue of candidate leaves ordered by the reduction in Gini impurity of their best splits,
+		// weighted by group size, and splits the best until the tree has the maximum number of leaves
+		best_first
+	};
+
+
+	// struct holding the options which control how a decision tree is trained
+	struct DecisionTreeSettings
+	{
+		// method used to search for the best split point of each node
+		SplitMethod split_method = SplitMethod::exhaustive;
+		// order in which the tree's nodes are grown
+		GrowthPolicy growth_policy = GrowthPolicy::depth_first;
+		// maximum depth of a node which splits, i.e. of the tree
+		int max_depth = 6;
+		// minimum group size of a node for it to split
+		int min_split_group_size = 11;
+		// maximum number of leaves of a tree grown best first
+		int max_leaves = 32;
+
+		// number of threads with which to train, where subtrees are trained as tasks on a
+		// work-stealing thread pool if more than one, which builds the same tree as training serially
+		int n_threads = 1;
+		// minimum group size of a left child node for it to be trained as a separate task
+		int parallel_min_group_size = 128;
+		// minimum group size of a node for its split search to be divided between the threads, by chunks of its
+		// group or sorted lists and by variable, which also builds the same tree as training serially
+		int parallel_split_search_min_group_size = 1024;
+
+		// number of randomly chosen variables each node considers splitting on, or 0 to consider all of them
+		int max_features = 0;
+		// number of thresholds per variable drawn by the random thresholds split method
+		int n_random_thresholds = 3;
+		// seed of the tree's root node, from which every other node's seed is derived
+		uint64_t seed = 0;
+	};
+
+
+	// returns whether a tree trained with the given settings searches class histograms, which need the training set quantized
+	inline bool uses_histograms(const DecisionTreeSettings& settings)
+	{
+		return settings.split_method == SplitMethod::histogram || settings.growth_policy == GrowthPolicy::level_wise;
+	}
+
+
+	// returns whether a tree trained with the given settings sweeps per-feature sorted row index lists held in a workspace
+	inline bool uses_sorted_indices(const DecisionTreeSettings& settings)
+	{
+		return settings.split_method == SplitMethod::sorted_sweep && settings.growth_policy != GrowthPolicy::level_wise;
+	}
+
+
+	// struct holding the options which control how a gradient boosting model is trained
+	struct GradientBoostingSettings
+	{
+		// number of boosting rounds, each of which adds one regression tree
+		int n_rounds = 100;
+		// shrinkage applied to the leaf values of each tree
+		double learning_rate = 0.1;
+		// maximum depth of each tree
+		int max_depth = 6;
+		// L2 regularization of leaf values, added to the sum of hessians of a leaf's group
+		double l2_regularization = 1.0;
+		// minimum sum of hessians of each child of a split
+		double min_child_weight = 1.0;
+		// minimum reduction in loss for a node to be split
+		double min_split_gain = 0.0;
+
+		// proportion of the training rows, drawn without replacement, on which each tree is trained
+		double row_subsample = 1.0;
+		// proportion of the variables which each tree considers splitting on
+		double col_subsample = 1.0;
+		// seed from which each round's row and variable samples are derived
+		uint64_t seed = 0;
+
+		// number of threads with which to train, where each node's histograms are built by variable
+		// as tasks on a work-stealing thread pool if more than one
+		int n_threads = 1;
+		// minimum group size of a node for its histograms to be built in parallel
+		int parallel_min_group_size = 1024;
+	};
+
+
+	// struct holding the options which control how a Hoeffding tree learns from a stream of rows
+	struct HoeffdingTreeSettings
+	{
+		// number of rows a leaf learns from between attempts to split it
+		int grace_period = 200;
+		// probability that a split chosen by the Hoeffding bound is not the split the whole stream would choose
+		double split_confidence = 1e-7;
+		// difference in Gini reduction below which the best two splits are considered tied, and the best is taken
+		// once the Hoeffding bound falls below it
+		double tie_threshold = 0.05;
+		// number of evenly spaced thresholds between the minimum and maximum value of each variable seen by a leaf
+		// which are evaluated as split points
+		int n_split_points = 10;
+		// maximum depth of a leaf which splits, i.e. of the tree
+		int max_depth = 20;
+		// maximum number of leaves, beyond which no leaf splits, which bounds the memory used by the tree
+		int max_leaves = 1024;
+	};
+
+
+	// mixes a seed with a stream number to give an independent seed, using the splitmix64 finalizer,
+	// so that a node's children, or the trees of an ensemble, draw different random numbers
+	inline uint64_t mix_seed(uint64_t seed, uint64_t stream)
+	{
+		uint64_t z = seed + (stream + 1) * 0x9E3779B97F4A7C15ULL;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <cstdint>
+
+#include "DecisionTreeDataset.h"
+
+
+namespace MLComparison
+{
+	// class template for the working storage used while training a decision tree with the sorted sweep
+	// split method, i.e. one list of row indices per independent variable which is sorted by that variable
+	// once at the root and then stably partitioned alongside the training set's row indices at each split,
+	// so that every node's group occupies the same range of positions in each list
+	template<typename T, int dataset_x_vars>
+	class DecisionTreeWorkspace
+	{
+	public:
+
+		// constructor which takes the training dataset, iterators defining the root node's group of
+		// row indices and the number of independent variables to use, and sorts the group by each variable
+		DecisionTreeWorkspace(std::shared_ptr<DecisionTreeDataset<T, dataset_x_vars>> training_dataset,
+			std::vector<int>::iterator group_begin_it, std::vector<int>::iterator group_end_it, int dataset_x_vars_to_use = dataset_x_vars) :
+			indices_base(group_begin_it), x_vars_to_use(dataset_x_vars_to_use)
+		{
+			// per-row scratch space is indexed by row index, so size it to the whole dataset
+			group_positions.resize(training_dataset->get_n_rows());
+			goes_left.resize(training_dataset->get_n_rows());
+			// partition buffer mirrors the group, so each node uses the same range of it as of the sorted lists
+			partition_buffer.resize(std::distance(group_begin_it, group_end_it));
+			sorted_indices.resize(x_vars_to_use);
+
+			// for each independent variable to use
+			for (int col = 0; col < x_vars_to_use; col++)
+			{
+				// copy the group's row indices and sort them by the variable's value
+				const T* column = training_dataset->column_data(col);
+				sorted_indices[col].assign(group_begin_it, group_end_it);
+				std::sort(sorted_indices[col].begin(), sorted_indices[col].end(),
+					[column](int a, int b) -> bool {
+						return column[a] < column[b];
+					}
+				);
+			}
+		}
+
+
+		// returns the offset of a node's group from the start of the root node's group
+		auto get_offset(std::vector<int>::iterator group_begin_it) const
+		{
+			return std::distance(indices_base, group_begin_it);
+		}
+
+
+		// returns an iterator pointing to the start of a node's group in the list sorted by the given variable
+		auto sorted_begin(int col, std::ptrdiff_t offset)
+		{
+			return sorted_indices[col].begin() + offset;
+		}
+
+
+		// records the position of a row within the group of the node currently searching for a split
+		void set_group_position(int row, int position)
+		{
+			group_positions[row] = position;
+		}
+
+
+		// returns the position of a row within the group of the node currently searching for a split
+		int get_group_position(int row) const
+		{
+			return group_positions[row];
+		}
+
+
+		// stably partitions a node's range of each sorted list according to a split of its row indices,
+		// so that the left and right child nodes each find their groups still sorted at the front and back
+		void partition_sorted_indices(std::vector<int>::iterator group_begin_it, std::vector<int>::iterator split_point,
+			std::vector<int>::iterator group_end_it)
+		{
+			// mark which side of the split each row of the group falls on
+			for (auto it = group_begin_it; it < split_point; ++it)
+			{
+				goes_left[*it] = 1;
+			}
+			for (auto it = split_point; it < group_end_it; ++it)
+			{
+				goes_left[*it] = 0;
+			}
+
+			// range of the node's group within the sorted lists and partition buffer
+			auto offset = get_offset(group_begin_it);
+			auto group_size = std::distance(group_begin_it, group_end_it);
+			auto left_size = std::distance(group_begin_it, split_point);
+
+			// for each sorted list
+			for (int col = 0; col < x_vars_to_use; col++)
+			{
+				auto sorted_it = sorted_begin(col, offset);
+				// write rows going left to the front of the buffer and rows going right after them,
+				// preserving their sorted order
+				auto left_it = partition_buffer.begin() + offset;
+				auto right_it = left_it + left_size;
+				for (auto it = sorted_it; it < sorted_it + group_size; ++it)
+				{
+					if (goes_left[*it])
+					{
+						*left_it++ = *it;
+					}
+					else
+					{
+						*right_it++ = *it;
+					}
+				}
+				// copy the partitioned range back into the sorted list
+				std::copy(partition_buffer.begin() + offset, partition_buffer.begin() + offset + group_size, sorted_it);
+			}
+		}
+
+
+	private:
+
+		// iterator pointing to the first row index of the root node's group
+		std::vector<int>::iterator indices_base;
+
+		// number of independent variables for which sorted lists are kept
+		int x_vars_to_use;
+
+		// lists of the root node's row indices sorted by each independent variable
+		std::vector<std::vector<int>> sorted_indices = {};
+		// position of each row within the group of the node currently searching for a split, indexed by row
+		std::vector<int> group_positions = {};
+		// whether each row falls on the left of the most recent split of its group, indexed by row
+		std::vector<uint8_t> goes_left = {};
+		// buffer used when partitioning the sorted lists
+		std::vector<int> partition_buffer = {};
+	};
+}
@@ -0,0 +1,283 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <random>
+#include <cmath>
+
+#include "GradMatrix.h"
+#include "SparseDataset.h"
+
+
+namespace MLComparison
+{
+	// class template for a linear neural network layer with a given number of units (neurons) whose number of
+	// inputs is only known at run time, suitable as the first layer of a network whose inputs are rows of a
+	// dataset whose width is read from its file; the weights are stored input by input, so that each input's
+	// weights for every unit are contiguous and the loops over the units, whose length is fixed, can be vectorized;
+	// the inputs may also be a row of a sparse dataset, in which case only the weights of its non-zero inputs are
+	// read in the forward pass and updated, so that the cost of a pass scales with the number of non-zero inputs
+	template<typename T, int n_units>
+	class DynamicLinear
+	{
+	public:
+
+		// default constructor
+		DynamicLinear()
+		{
+		}
+
+
+		// constructor which additionally sets the learning rate
+		DynamicLinear(T layer_learning_rate) : learning_rate(layer_learning_rate)
+		{
+		}
+
+
+		// constructor which creates a replica of a layer with the same learning rate, which reads and updates the
+		// weights and biases of the original layer without locks, tolerating races between the threads which train
+		// them, where a sparse row's update only writes the weights of its non-zero inputs; the original's weights
+		// must have been initialized before its replicas are used
+		DynamicLinear(DynamicLinear& shared_layer, SharedParametersTag) :
+			learning_rate(shared_layer.learning_rate),
+			shared_layer_ptr(&shared_layer.parameter_layer())
+		{
+		}
+
+
+		// getter for learning rate
+		T get_lr()
+		{
+			return learning_rate;
+		}
+
+
+		// setter for learning rate
+		void set_lr(T new_learning_rate)
+		{
+			learning_rate = new_learning_rate;
+		}
+
+
+		// initializes weights for the given number of inputs according to the Kaiming He initialization scheme,
+		// drawing them in the same order as a Linear layer with that many inputs
+		void kaiming_he_init(size_t n_inputs)
+		{
+			// create random number generator
+			std::default_random_engine rng;
+			// normal distribution with mean 0 and sd of sqrt(2 / n_inputs)
+			std::normal_distribution<T> dist_norm(0, std::sqrt(2.0 / n_inputs));
+			// set each weight to a random number drawn from the distribution, and zero the biases
+			weights.resize(n_inputs * n_units);
+			weight_grads.assign(n_inputs * n_units, 0);
+			for (auto& weight : weights)
+			{
+				weight = dist_norm(rng);
+			}
+			biases = Matrix<T, 1, n_units>();
+		}
+
+
+		// performs the forward pass, calculating outputs based on the inputs, weights and biases; the weights are
+		// initialized on the first pass, once the number of inputs is known
+		Matrix<T, 1, n_units>* operator()(const std::vector<T>* x)
+		{
+			DynamicLinear& parameters = parameter_layer();
+			prepare(parameters, x->size());
+			// save pointer to the inputs for the backward pass
+			input_vector = x;
+			sparse_input = nullptr;
+
+			// the output of each unit is the sum of each input multiplied by that unit's weight for it, plus its bias
+			std::array<T, n_units> sums = {};
+			const T* input_weights = parameters.weights.data();
+			for (size_t input = 0; input < x->size(); input++, input_weights += n_units)
+			{
+				T input_value = (*x)[input];
+				for (int unit = 0; unit < n_units; unit++)
+				{
+					sums[unit] += input_value * input_weights[unit];
+				}
+			}
+			for (int unit = 0; unit < n_units; unit++)
+			{
+				output_matrix[0][unit] = sums[unit] + parameters.biases[0][unit];
+			}
+
+			// return the outputs
+			return &output_matrix;
+		}
+
+
+		// performs the forward pass for a row of a sparse dataset, where only the weights of its non-zero inputs
+		// contribute to the outputs
+		Matrix<T, 1, n_units>* operator()(const SparseRow<T>* x)
+		{
+			DynamicLinear& parameters = parameter_layer();
+			prepare(parameters, x->size());
+			// save pointer to the inputs for the backward pass
+			sparse_input = x;
+			input_vector = nullptr;
+
+			// the output of each unit is the sum of each non-zero input multiplied by that unit's weight for it, plus its bias
+			std::array<T, n_units> sums = {};
+			for (int i = 0; i < x->nnz; i++)
+			{
+				T input_value = x->values[i];
+				const T* input_weights = parameters.weights.data() + static_cast<size_t>(x->cols[i]) * n_units;
+				for (int unit = 0; unit < n_units; unit++)
+				{
+					sums[unit] += input_value * input_weights[unit];
+				}
+			}
+			for (int unit = 0; unit < n_units; unit++)
+			{
+				output_matrix[0][unit] = sums[unit] + parameters.biases[0][unit];
+			}
+
+			// return the outputs
+			return &output_matrix;
+		}
+
+
+		// performs the backwards pass, calculating the gradients of the parameters based on the gradients of the
+		// output matrix; no gradients are calculated for the inputs, which are rows of a dataset
+		void backward()
+		{
+			// if inputs exist
+			if (input_vector != nullptr)
+			{
+				// the gradient of each weight is the product of its input and the gradient of its unit's output
+				T* input_weight_grads = weight_grads.data();
+				for (size_t input = 0; input < input_vector->size(); input++, input_weight_grads += n_units)
+				{
+					T input_value = (*input_vector)[input];
+					for (int unit = 0; unit < n_units; unit++)
+					{
+						input_weight_grads[unit] = input_value * output_matrix.grad[0][unit];
+					}
+				}
+				// gradients of the biases are simply the gradients of the outputs
+				bias_grads = output_matrix.grad;
+			}
+			// if the inputs are a sparse row, the gradients of the weights of the other inputs are zero, so only
+			// those of its non-zero inputs are calculated, stored in the order of its entries
+			else if (sparse_input != nullptr)
+			{
+				T* input_weight_grads = weight_grads.data();
+				for (int i = 0; i < sparse_input->nnz; i++, input_weight_grads += n_units)
+				{
+					T input_value = sparse_input->values[i];
+					for (int unit = 0; unit < n_units; unit++)
+					{
+						input_weight_grads[unit] = input_value * output_matrix.grad[0][unit];
+					}
+				}
+				bias_grads = output_matrix.grad;
+			}
+		}
+
+
+		// updates the weights and biases, in double precision as GradMatrix::SGDStep does, where only the weights of
+		// the non-zero inputs are updated if the inputs are a sparse row
+		void update()
+		{
+			DynamicLinear& parameters = parameter_layer();
+			if (sparse_input != nullptr)
+			{
+				const T* input_weight_grads = weight_grads.data();
+				for (int i = 0; i < sparse_input->nnz; i++, input_weight_grads += n_units)
+				{
+					T* input_weights = parameters.weights.data() + static_cast<size_t>(sparse_input->cols[i]) * n_units;
+					for (int unit = 0; unit < n_units; unit++)
+					{
+						input_weights[unit] -= static_cast<double>(learning_rate) * input_weight_grads[unit];
+					}
+				}
+			}
+			else
+			{
+				for (size_t i = 0; i < weight_grads.size(); i++)
+				{
+					parameters.weights[i] -= static_cast<double>(learning_rate) * weight_grads[i];
+				}
+			}
+			for (int unit = 0; unit < n_units; unit++)
+			{
+				parameters.biases[0][unit] -= static_cast<double>(learning_rate) * bias_grads[0][unit];
+			}
+		}
+
+
+		// returns the number of inputs for which the weights have been initialized, or 0 if they have not
+		size_t get_n_inputs() const
+		{
+			return parameter_layer().weights.size() / n_units;
+		}
+
+
+		// getter for the weights, stored input by input
+		const std::vector<T>& get_weights() const
+		{
+			return parameter_layer().weights;
+		}
+
+
+		// getter for the matrix of biases
+		const Matrix<T, 1, n_units>& get_biases() const
+		{
+			return parameter_layer().biases;
+		}
+
+
+	private:
+
+		// initializes the weights of the layer whose parameters are used if they are not for the given number of inputs,
+		// and sizes the layer's own gradients of the weights to match them
+		void prepare(DynamicLinear& parameters, size_t n_inputs)
+		{
+			if (parameters.weights.size() != n_inputs * n_units)
+			{
+				parameters.kaiming_he_init(n_inputs);
+			}
+			if (weight_grads.size() != parameters.weights.size())
+			{
+				weight_grads.assign(parameters.weights.size(), 0);
+			}
+		}
+
+
+		// returns the layer whose parameters are used, which is the layer itself unless it is a replica
+		DynamicLinear& parameter_layer()
+		{
+			return shared_layer_ptr != nullptr ? *shared_layer_ptr : *this;
+		}
+
+
+		// returns the layer whose parameters are used
+		const DynamicLinear& parameter_layer() const
+		{
+			return shared_layer_ptr != nullptr ? *shared_layer_ptr : *this;
+		}
+
+
+		// learning rate for the layer's parameters
+		T learning_rate = 0;
+
+		// pointer to the inputs of the last forward pass, which are either a vector or a sparse row
+		const std::vector<T>* input_vector = nullptr;
+		const SparseRow<T>* sparse_input = nullptr;
+		// matrix of outputs
+		GradMatrix<T, 1, n_units> output_matrix;
+
+		// weights and their gradients, stored input by input with the weight for each unit of an input contiguous,
+		// where the gradients of a sparse row's weights are stored for its non-zero inputs only
+		std::vector<T> weights = {};
+		std::vector<T> weight_grads = {};
+		// matrix of biases and their gradients
+		Matrix<T, 1, n_units> biases;
+		Matrix<T, 1, n_units> bias_grads;
+		// pointer to the layer whose parameters a replica uses, or null if the layer uses its own
+		DynamicLinear* shared_layer_ptr = nullptr;
+	};
+}
@@ -0,0 +1,465 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <memory>
+#include <string>
+#include <fstream>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+
+#include "MappedFile.h"
+#include "export_header.h"
+
+
+namespace MLComparison
+{
+	// struct for a node of a flattened decision tree, packed into 8 bytes so that eight fit in a cache line
+	struct FlatTreeNode
+	{
+		// split value, compared against the sample's value of the split variable in single precision,
+		// or the class prediction, 0 or 1, if the node is a leaf
+		float split_val;
+		// index of the left child node, whose sibling is the right child node at the next index,
+		// or 0 if the node is a leaf, as the root node at index 0 is never a child
+		uint16_t left;
+		// split variable if the node is not a leaf, or 0 if it is, as groups of samples walked down the tree
+		// together read it at leaves too
+		uint16_t split_var;
+	};
+
+	// saved trees store their nodes exactly as they are laid out in memory on a little-endian machine
+	static_assert(sizeof(FlatTreeNode) == 8, "FlatTreeNode must be packed into 8 bytes");
+	static_assert(std::numeric_limits<float>::is_iec559, "split values are saved as IEEE 754 single precision");
+
+
+	// class for a trained binary classification decision tree compiled into a contiguous array of nodes
+	// in breadth-first order, which holds none of the training state of the tree it was compiled from
+	// and makes predictions with an iterative loop rather than recursing through pointers; the nodes are never
+	// modified once compiled or loaded, so copies of a tree share them, whether they are owned or memory-mapped
+	//
+	// trees are saved in a versioned binary format in which every field is little-endian:
+	//   bytes 0-3    magic number "MLCT"
+	//   bytes 4-5    format version, currently 2
+	//   bytes 6-7    size of a node in bytes, 8
+	//   bytes 8-11   number of nodes
+	//   bytes 12-15  depth of the deepest leaf
+	//   bytes 16-    nodes in breadth-first order, each an IEEE 754 single precision split value or leaf's class
+	//                prediction followed by a 16-bit left child index and a 16-bit split variable
+	// version 1 files, whose nodes end with an 8-bit split variable and an 8-bit class prediction, are still loaded
+	class FlatDecisionTree
+	{
+	public:
+
+		// default constructor which leaves the tree empty
+		FlatDecisionTree()
+		{
+		}
+
+
+		// constructor which compiles the tree with the given root node
+		template<typename NodeType>
+		explicit FlatDecisionTree(const NodeType& root)
+		{
+			compile(root);
+		}
+
+
+		// compiles the tree with the given root node, which must be trained, into breadth-first order
+		template<typename NodeType>
+		void compile(const NodeType& root)
+		{
+			// queue of nodes in breadth-first order, where each node's index in the queue is its index in the
+			// array, and the depth of each node
+			std::vector<const NodeType*> queue = { &root };
+			std::vector<int> node_depths = { 0 };
+			std::vector<FlatTreeNode> nodes(1);
+			depth = 0;
+
+			// for each node in the queue
+			for (size_t i = 0; i < queue.size(); i++)
+			{
+				const NodeType* node = queue[i];
+				depth = std::max(depth, node_depths[i]);
+				// leaf nodes only hold their prediction
+				if (node->is_leaf())
+				{
+					nodes[i] = { static_cast<float>(node->get_class_prediction()), 0, 0 };
+				}
+				// other nodes' children are appended to the queue next to each other
+				else
+				{
+					size_t left_index = queue.size();
+					if (left_index + 1 > UINT16_MAX)
+					{
+						throw std::length_error("FlatDecisionTree: too many nodes for 16-bit indices");
+					}
+					if (node->get_split_var() > UINT16_MAX)
+					{
+						throw std::out_of_range("FlatDecisionTree: split variable does not fit in 16 bits");
+					}
+					queue.push_back(node->get_left());
+					queue.push_back(node->get_right());
+					node_depths.push_back(node_depths[i] + 1);
+					node_depths.push_back(node_depths[i] + 1);
+					nodes.resize(queue.size());
+					nodes[i] = { static_cast<float>(node->get_split_val()), static_cast<uint16_t>(left_index),
+						static_cast<uint16_t>(node->get_split_var()) };
+				}
+			}
+
+			// the tree owns the compiled nodes
+			set_nodes(std::move(nodes));
+		}
+
+
+		// saves the tree to a file in the binary format described above
+		void save(const std::string& file_name) const
+		{
+			// encode the header and each field of each node in little-endian byte order
+			std::vector<unsigned char> bytes;
+			bytes.reserve(header_size + n_nodes * sizeof(FlatTreeNode));
+			bytes.insert(bytes.end(), { 'M', 'L', 'C', 'T' });
+			append_little_endian(bytes, format_version, 2);
+			append_little_endian(bytes, sizeof(FlatTreeNode), 2);
+			append_little_endian(bytes, n_nodes, 4);
+			append_little_endian(bytes, depth, 4);
+			for (size_t i = 0; i < n_nodes; i++)
+			{
+				uint32_t split_val_bits;
+				std::memcpy(&split_val_bits, &node_data[i].split_val, sizeof(split_val_bits));
+				append_little_endian(bytes, split_val_bits, 4);
+				append_little_endian(bytes, node_data[i].left, 2);
+				append_little_endian(bytes, node_data[i].split_var, 2);
+			}
+
+			// write the file
+			std::ofstream outfile(file_name, std::ios::binary | std::ios::trunc);
+			outfile.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+			if (!outfile)
+			{
+				throw std::runtime_error("FlatDecisionTree: cannot write " + file_name);
+			}
+		}
+
+
+		// exports the tree as a self-contained C++ header defining a function template of the given name, which makes
+		// the tree's prediction for a sample by nested comparisons of its variables against constant split values,
+		// so that the tree can be compiled into a program rather than loaded; the comparisons are made in single
+		// precision, as predict makes them, so the function's predictions are the tree's
+		void export_header(const std::string& file_name, const std::string& function_name) const
+		{
+			if (empty())
+			{
+				throw std::logic_error("FlatDecisionTree: no tree to export");
+			}
+			check_identifier(function_name);
+
+			std::ostringstream text;
+			text << "#pragma once\n\n\n";
+			text << "// decision tree with " << n_nodes << " nodes and depth " << depth << ", exported as nested comparisons;\n";
+			text << "// returns the predicted class, 0 or 1, for a sample whose independent variables are indexed by sample[i]\n";
+			text << "template<typename SampleType>\ninline int " << function_name << "(const SampleType& sample)\n{\n";
+			write_node_code(text, 0, 1);
+			text << "}\n";
+			write_header_file(file_name, text.str());
+		}
+
+
+		// loads a tree saved by save in place of this one; on a little-endian machine a file of the current version is
+		// memory-mapped and its nodes are used where they lie, without being copied or decoded, and otherwise, or if the
+		// file cannot be mapped, it is read and decoded; throws std::runtime_error if the file cannot be read or is not a
+		// valid tree
+		void load(const std::string& file_name)
+		{
+			// map the file if the nodes it holds can be used in place
+			std::shared_ptr<const MappedFile> file = nullptr;
+			if (is_little_endian())
+			{
+				try
+				{
+					file = std::make_shared<const MappedFile>(file_name);
+				}
+				catch (const std::runtime_error&)
+				{
+					file = nullptr;
+				}
+			}
+
+			// use the mapped nodes after checking them if they are laid out as in memory
+			if (file != nullptr && file->size() >= header_size && read_little_endian(file->data() + 4, 2) == format_version)
+			{
+				int file_depth = check_header(file->data(), file->size(), file_name);
+				size_t file_n_nodes = static_cast<size_t>(read_little_endian(file->data() + 8, 4));
+				const FlatTreeNode* file_nodes = reinterpret_cast<const FlatTreeNode*>(file->data() + header_size);
+				check_nodes(file_nodes, file_n_nodes, file_depth, file_name);
+				node_data = file_nodes;
+				n_nodes = file_n_nodes;
+				depth = file_depth;
+				storage = file;
+				return;
+			}
+
+			// otherwise read the file and decode its nodes
+			std::ifstream infile(file_name, std::ios::binary);
+			if (!infile)
+			{
+				throw std::runtime_error("FlatDecisionTree: cannot open " + file_name);
+			}
+			std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(infile)), std::istreambuf_iterator<char>());
+			int file_depth = check_header(bytes.data(), bytes.size(), file_name);
+			bool is_version_1 = read_little_endian(bytes.data() + 4, 2) == 1;
+			std::vector<FlatTreeNode> nodes(static_cast<size_t>(read_little_endian(bytes.data() + 8, 4)));
+			for (size_t i = 0; i < nodes.size(); i++)
+			{
+				const unsigned char* node_bytes = bytes.data() + header_size + i * sizeof(FlatTreeNode);
+				uint32_t split_val_bits = static_cast<uint32_t>(read_little_endian(node_bytes, 4));
+				std::memcpy(&nodes[i].split_val, &split_val_bits, sizeof(split_val_bits));
+				nodes[i].left = static_cast<uint16_t>(read_little_endian(node_bytes + 4, 2));
+				nodes[i].split_var = static_cast<uint16_t>(read_little_endian(node_bytes + 6, 2));
+				// version 1 leaves hold their class prediction in the last byte rather than the split value
+				if (is_version_1)
+				{
+					nodes[i].split_var = node_bytes[6];
+					if (nodes[i].left == 0)
+					{
+						nodes[i].split_val = static_cast<float>(node_bytes[7]);
+					}
+				}
+			}
+			check_nodes(nodes.data(), nodes.size(), file_depth, file_name);
+			set_nodes(std::move(nodes));
+			depth = file_depth;
+		}
+
+
+		// method template for making a prediction based on a sample, which steps from each node to the
+		// left child or its right-hand sibling by adding the result of the comparison to the left index
+		template<typename SampleType>
+		int predict(const SampleType& sample) const
+		{
+			uint32_t i = 0;
+			while (node_data[i].left != 0)
+			{
+				const FlatTreeNode& node = node_data[i];
+				i = node.left + !(static_cast<float>(sample[node.split_var]) < node.split_val);
+			}
+			return static_cast<int>(node_data[i].split_val);
+		}
+
+
+		// method template for making predictions for a range of samples, writing them to the given output iterator;
+		// samples are taken in groups which are walked down the tree together one level at a time, with every
+		// sample taking as many steps as the tree is deep and leaves stepping to themselves, so the steps of a
+		// group's samples are independent, free of branches and can overlap their memory accesses
+		template<typename RowIterator, typename OutputIterator>
+		void predict_batch(RowIterator first, RowIterator last, OutputIterator predictions) const
+		{
+			// pointers to the current group of samples and the index of the node each sample has reached
+			std::array<const typename std::iterator_traits<RowIterator>::value_type*, batch_width> samples;
+			std::array<uint32_t, batch_width> node_indices;
+
+			// for each group of samples
+			while (first != last)
+			{
+				// get pointers to the group's samples, repeating the first sample to fill a final partial group
+				int n_samples = 0;
+				for (; first != last && n_samples < batch_width; ++first, n_samples++)
+				{
+					samples[n_samples] = &*first;
+				}
+				std::fill(samples.begin() + n_samples, samples.end(), samples[0]);
+
+				// walk the samples down the tree from the root
+				node_indices.fill(0);
+				for (int level = 0; level < depth; level++)
+				{
+					for (int i = 0; i < batch_width; i++)
+					{
+						const FlatTreeNode& node = node_data[node_indices[i]];
+						uint32_t next = node.left + !(static_cast<float>((*samples[i])[node.split_var]) < node.split_val);
+						node_indices[i] = node.left != 0 ? next : node_indices[i];
+					}
+				}
+
+				// output the prediction of the leaf each sample has reached
+				for (int i = 0; i < n_samples; i++)
+				{
+					*predictions++ = static_cast<int>(node_data[node_indices[i]].split_val);
+				}
+			}
+		}
+
+
+		// returns whether the tree has been compiled or loaded
+		bool empty() const
+		{
+			return n_nodes == 0;
+		}
+
+
+		// returns the number of nodes in the tree
+		size_t size() const
+		{
+			return n_nodes;
+		}
+
+
+		// returns the depth of the deepest leaf in the tree
+		int get_depth() const
+		{
+			return depth;
+		}
+
+
+		// returns a pointer to the array of nodes
+		const FlatTreeNode* data() const
+		{
+			return node_data;
+		}
+
+
+	private:
+
+		// writes the code of the subtree whose root is the node at the given index, indented by the given number of tabs,
+		// where a leaf returns its class prediction and any other node branches to its children's code
+		void write_node_code(std::ostringstream& text, size_t i, int indent) const
+		{
+			std::string tabs(indent, '\t');
+			const FlatTreeNode& node = node_data[i];
+			if (node.left == 0)
+			{
+				text << tabs << "return " << static_cast<int>(node.split_val) << ";\n";
+				return;
+			}
+			text << tabs << "if (static_cast<float>(sample[" << node.split_var << "]) < " << format_float_literal(node.split_val, true) << ")\n";
+			text << tabs << "{\n";
+			write_node_code(text, node.left, indent + 1);
+			text << tabs << "}\n" << tabs << "else\n" << tabs << "{\n";
+			write_node_code(text, node.left + 1, indent + 1);
+			text << tabs << "}\n";
+		}
+
+
+		// makes the tree own the given nodes, replacing any it shared before
+		void set_nodes(std::vector<FlatTreeNode>&& nodes)
+		{
+			auto owned_nodes = std::make_shared<const std::vector<FlatTreeNode>>(std::move(nodes));
+			node_data = owned_nodes->data();
+			n_nodes = owned_nodes->size();
+			storage = owned_nodes;
+		}
+
+
+		// returns whether the machine stores integers with their least significant byte first
+		static bool is_little_endian()
+		{
+			const uint16_t one = 1;
+			unsigned char first_byte;
+			std::memcpy(&first_byte, &one, 1);
+			return first_byte == 1;
+		}
+
+
+		// appends the given number of bytes of a value to an array of bytes, least significant first
+		static void append_little_endian(std::vector<unsigned char>& bytes, uint64_t value, int n_bytes)
+		{
+			for (int i = 0; i < n_bytes; i++)
+			{
+				bytes.push_back(static_cast<unsigned char>(value >> (8 * i)));
+			}
+		}
+
+
+		// reads a value of the given number of bytes from an array of bytes, least significant first
+		static uint64_t read_little_endian(const unsigned char* bytes, int n_bytes)
+		{
+			uint64_t value = 0;
+			for (int i = 0; i < n_bytes; i++)
+			{
+				value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+			}
+			return value;
+		}
+
+
+		// checks the header of a saved tree and that the file is long enough to hold its nodes, returning its depth
+		static int check_header(const unsigned char* bytes, size_t n_bytes, const std::string& file_name)
+		{
+			if (n_bytes < header_size || std::memcmp(bytes, "MLCT", 4) != 0)
+			{
+				throw std::runtime_error("FlatDecisionTree: " + file_name + " is not a saved decision tree");
+			}
+			uint64_t version = read_little_endian(bytes + 4, 2);
+			if (version < 1 || version > format_version || read_little_endian(bytes + 6, 2) != sizeof(FlatTreeNode))
+			{
+				throw std::runtime_error("FlatDecisionTree: " + file_name + " has an unsupported format version");
+			}
+			uint64_t file_n_nodes = read_little_endian(bytes + 8, 4);
+			uint64_t file_depth = read_little_endian(bytes + 12, 4);
+			if (file_n_nodes == 0 || file_n_nodes > UINT16_MAX || file_depth >= file_n_nodes
+				|| n_bytes != header_size + file_n_nodes * sizeof(FlatTreeNode))
+			{
+				throw std::runtime_error("FlatDecisionTree: " + file_name + " has the wrong length for its number of nodes");
+			}
+			return static_cast<int>(file_depth);
+		}
+
+
+		// checks that the children of each node come after it and lie within the array, so that every
+		// prediction reaches a leaf in a bounded number of steps without reading outside the nodes, that
+		// leaves predict 0 or 1 and have split variable 0, as predict_batch reads it even at a leaf, and
+		// that the depth of the deepest leaf reachable from the root is the given depth from the header,
+		// as predict_batch takes that many steps and would otherwise stop some samples at split nodes
+		static void check_nodes(const FlatTreeNode* nodes, size_t n, int file_depth, const std::string& file_name)
+		{
+			// depth of each node reachable from the root, or -1 if it is not reached, which is final by the
+			// time the node is checked as its parents come before it
+			std::vector<int> node_depths(n, -1);
+			node_depths[0] = 0;
+			int max_depth = 0;
+			for (size_t i = 0; i < n; i++)
+			{
+				size_t left = nodes[i].left;
+				bool is_valid_leaf = nodes[i].split_var == 0 && (nodes[i].split_val == 0.0f || nodes[i].split_val == 1.0f);
+				if (left != 0 ? left <= i || left + 1 >= n : !is_valid_leaf)
+				{
+					throw std::runtime_error("FlatDecisionTree: " + file_name + " has an invalid child index or leaf");
+				}
+				if (node_depths[i] >= 0 && left != 0)
+				{
+					node_depths[left] = std::max(node_depths[left], node_depths[i] + 1);
+					node_depths[left + 1] = std::max(node_depths[left + 1], node_depths[i] + 1);
+				}
+				max_depth = std::max(max_depth, node_depths[i]);
+			}
+			if (max_depth != file_depth)
+			{
+				throw std::runtime_error("FlatDecisionTree: " + file_name + " has a depth which does not match its nodes");
+			}
+		}
+
+
+		// number of samples walked down the tree together by predict_batch
+		static const int batch_width = 16;
+
+		// length of the header of a saved tree in bytes, and the version of the format written
+		static const size_t header_size = 16;
+		static const uint16_t format_version = 2;
+
+		// nodes of the tree in breadth-first order and the number of them
+		const FlatTreeNode* node_data = nullptr;
+		size_t n_nodes = 0;
+
+		// owner of the nodes, either a vector of them or the file they are mapped from, shared by copies of the tree
+		std::shared_ptr<const void> storage = nullptr;
+
+		// depth of the deepest leaf in the tree
+		int depth = 0;
+	};
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <random>
+#include <cmath>
+
+#include "base_layers.h"
+#include "Relu.h"
+#include "Sigmoid.h"
+
+
+namespace MLComparison
+{
+	// class template for a linear neural network layer followed by an activation function layer, such as Relu or
+	// Sigmoid, whose static activate and derivative functions are applied to the layer's outputs as soon as they are
+	// calculated rather than in a pass of their own; the forward pass keeps the derivative of the activation function
+	// at each output, so that the backward pass does not need the linear outputs, and the backward pass also updates
+	// the parameters with a step of gradient descent as their gradients are calculated, rather than storing them for
+	// the update, which is therefore done by the backward pass and leaves nothing for update to do; the gradients of
+	// the inputs are calculated before the weights are updated, so a network of these layers is trained exactly as if
+	// the update were made after the backward pass of every layer
+	template<typename T, int n_inputs, int n_units, template<typename, int, size_t> class Activation, size_t batch_size = 1>
+	class FusedLinear : public TrainableLayer<T, n_inputs, n_units, batch_size>
+	{
+	public:
+
+		// default constructor
+		FusedLinear()
+		{
+		}
+
+
+		// constructor which additionally sets the learning rate
+		FusedLinear(T learning_rate) : TrainableLayer<T, n_inputs, n_units, batch_size>(learning_rate)
+		{
+		}
+
+
+		// constructor which creates a replica of a layer with the same learning rate, which reads and updates the
+		// parameters of the original layer without locks, tolerating races between the threads which train them
+		FusedLinear(FusedLinear& shared_layer, SharedParametersTag) :
+			TrainableLayer<T, n_inputs, n_units, batch_size>(shared_layer.learning_rate),
+			shared_layer_ptr(&shared_layer.parameter_layer())
+		{
+		}
+
+
+		// initializes weights according to the Kaiming He initialization scheme, as Linear does
+		void kaiming_he_init()
+		{
+			// create random number generator
+			std::default_random_engine rng;
+			// normal distribution with mean 0 and sd of sqrt(2 / n_inputs)
+			std::normal_distribution<T> dist_norm(0, std::sqrt(2.0 / n_inputs));
+			// set each weight to a random number drawn from specified distribution
+			for (int row = 0; row < n_inputs; row++)
+			{
+				for (int col = 0; col < n_units; col++)
+				{
+					weights[row][col] = dist_norm(rng);
+				}
+			}
+		}
+
+
+		// performs the forward pass, calculating the activations of the outputs of the linear layer, which are the
+		// biases added to each row of the dot product of the input matrix and the weights, in one pass over the
+		// dot product, along with the derivatives of the activation function at each
+		virtual Matrix<T, batch_size, n_units>* operator()(Matrix<T, batch_size, n_inputs>* x) override
+		{
+			// save pointer to the input matrix for the backward pass
+			forward_record.input_matrix = x;
+			FusedLinear& parameters = parameter_layer();
+			Matrix<T, batch_size, n_units> products = x->dot(parameters.weights);
+			for (int row = 0; row < static_cast<int>(batch_size); row++)
+			{
+				for (int col = 0; col < n_units; col++)
+				{
+					T linear_output = products[row][col] + parameters.biases[0][col];
+					T output = Activation<T, n_units, batch_size>::activate(linear_output);
+					forward_record.output_matrix[row][col] = output;
+					activation_derivatives[row][col] = Activation<T, n_units, batch_size>::derivative(linear_output, output);
+				}
+			}
+			// return the outputs
+			return &forward_record.output_matrix;
+		}
+
+
+		// performs the backwards pass, calculating the gradients of the input matrix if it is gradient-enabled,
+		// and updating the parameters
+		virtual void backward() override
+		{
+			backward(dynamic_cast<GradMatrix<T, batch_size, n_inputs>*>(forward_record.input_matrix));
+		}
+
+
+		// performs the backwards pass given the input matrix of the forward pass as a gradient-enabled matrix, or a
+		// null pointer if its gradients are not needed, which avoids checking its type at run time
+		void backward(GradMatrix<T, batch_size, n_inputs>* grad_input_ptr)
+		{
+			// nothing to do if there has been no forward pass
+			if (forward_record.input_matrix == nullptr)
+			{
+				return;
+			}
+
+			FusedLinear& parameters = parameter_layer();
+
+			// gradients of the outputs of the linear layer are those of the activations multiplied by the derivatives
+			// of the activation function
+			Matrix<T, batch_size, n_units> linear_output_grads;
+			for (int row = 0; row < static_cast<int>(batch_size); row++)
+			{
+				for (int col = 0; col < n_units; col++)
+				{
+					linear_output_grads[row][col] = activation_derivatives[row][col] * forward_record.output_matrix.grad[row][col];
+				}
+			}
+
+			// gradients of the input matrix are the dot product of the gradients of the linear outputs and the transpose
+			// of the weights, calculated before the weights are updated
+			if (grad_input_ptr != nullptr)
+			{
+				grad_input_ptr->grad = linear_output_grads.dot_t(parameters.weights);
+			}
+
+			// the gradients of the weights are the dot product of the transpose of the input matrix and the gradients of
+			// the linear outputs, which are multiplied by the learning rate and subtracted from the weights as they are
+			// calculated rather than stored
+			parameters.weights.add_scaled_t_dot(-static_cast<double>(this->learning_rate), *forward_record.input_matrix, linear_output_grads);
+
+			// gradients of the biases are the gradients of the linear outputs summed over the batch's samples
+			Matrix<T, 1, n_units> bias_grads = linear_output_grads.sum_rows();
+			for (int col = 0; col < n_units; col++)
+			{
+				parameters.biases[0][col] -= static_cast<double>(this->learning_rate) * bias_grads[0][col];
+			}
+		}
+
+
+		// does nothing, as the parameters are updated by the backward pass
+		virtual void update() override
+		{
+		}
+
+
+		// getter for the matrix of weights, with a row for each input and a column for each unit
+		const Matrix<T, n_inputs, n_units>& get_weights() const
+		{
+			return parameter_layer().weights;
+		}
+
+
+		// getter for the matrix of biases
+		const Matrix<T, 1, n_units>& get_biases() const
+		{
+			return parameter_layer().biases;
+		}
+
+
+	private:
+
+		// returns the layer whose parameters are used, which is the layer itself unless it is a replica
+		FusedLinear& parameter_layer()
+		{
+			return shared_layer_ptr != nullptr ? *shared_layer_ptr : *this;
+		}
+
+
+		// returns the layer whose parameters are used
+		const FusedLinear& parameter_layer() const
+		{
+			return shared_layer_ptr != nullptr ? *shared_layer_ptr : *this;
+		}
+
+
+		// record of forward pass, whose outputs are the activations
+		ForwardRecord<T, n_inputs, n_units, batch_size> forward_record;
+		// derivative of the activation function at each output in the forward pass
+		Matrix<T, batch_size, n_units> activation_derivatives;
+
+		// matrix of weights
+		Matrix<T, n_inputs, n_units> weights;
+		// matrix of biases
+		Matrix<T, 1, n_units> biases;
+		// pointer to the layer whose parameters a replica uses, or null if the layer uses its own
+		FusedLinear* shared_layer_ptr = nullptr;
+	};
+
+
+	// alias template for a linear layer followed by a ReLU activation function
+	template<typename T, int n_inputs, int n_units, size_t batch_size = 1>
+	using LinearRelu = FusedLinear<T, n_inputs, n_units, Relu, batch_size>;
+
+
+	// alias template for a linear layer followed by a sigmoid activation function
+	template<typename T, int n_inputs, int n_units, size_t batch_size = 1>
+	using LinearSigmoid = FusedLinear<T, n_inputs, n_units, Sigmoid, batch_size>;
+}
@@ -0,0 +1,348 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include <array>
+#include <random>
+#include <numeric>
+#include <iterator>
+#include <algorithm>
+
+#include "DecisionTreeDataset.h"
+#include "DecisionTreeSettings.h"
+#include "RegressionTree.h"
+#include "WorkStealingThreadPool.h"
+#include "calculate_rows_to_use.h"
+
+
+namespace MLComparison
+{
+	// class template for a gradient boosting prediction model suitable for binary classification, i.e. a sum of
+	// regression trees each fitted to the gradients of the logistic loss of the trees before it, where the raw
+	// score of each training row is cached and updated with only the newest tree's value in each round
+	template<typename T, size_t dataset_x_vars>
+	class GradientBoostingModel
+	{
+	public:
+
+		// default constructor
+		GradientBoostingModel()
+		{
+		}
+
+
+		// constructor which takes the names of csv files for the training and validation sets
+		GradientBoostingModel(const std::string& train_csv, const std::string& valid_csv) :
+			validation_set(valid_csv)
+		{
+			// construct a new training dataset
+			training_set_ptr.reset(new DecisionTreeDataset<T, dataset_x_vars>);
+			// load training data
+			training_set_ptr->load_data(train_csv);
+		}
+
+
+		// get accuracy
+		T get_accuracy()
+		{
+			return validation_accuracy;
+		}
+
+
+		// get training settings
+		const GradientBoostingSettings& get_settings()
+		{
+			return settings;
+		}
+
+
+		// set training settings, which apply from the next call to train
+		void set_settings(const GradientBoostingSettings& new_settings)
+		{
+			settings = new_settings;
+		}
+
+
+		// loads a csv file as the training set
+		void load_training_set_file(const std::string& csv_file)
+		{
+			training_set_ptr->load_data(csv_file);
+		}
+
+
+		// loads a csv file as the validation set
+		void load_validation_set_file(const std::string& csv_file)
+		{
+			validation_set.load_data(csv_file);
+		}
+
+
+		// trains the model using a certain proportion of the training samples
+		// and a given number of fields within these samples
+		long long train(uint8_t eighths_rows_to_use, size_t x_vars_to_use)
+		{
+			// number of rows to use
+			size_t rows_to_use = calculate_rows_to_use(8, eighths_rows_to_use, training_set_ptr->size());
+			// number of fields to use, which cannot exceed the number in the training set, whose width may be read from its file
+			x_vars_to_use = std::min(x_vars_to_use, static_cast<size_t>(training_set_ptr->get_n_x_vars()));
+
+			// quantize the training set once, which is done as part of loading the data rather than training
+			if (!training_set_ptr->is_quantized())
+			{
+				training_set_ptr->quantize();
+			}
+
+			// get the thread pool, if any, before timing, as starting its threads is not part of training
+			WorkStealingThreadPool* thread_pool = get_thread_pool();
+
+			// get start time
+			the_clock::time_point start = the_clock::now();
+
+			// rows used for training, of which each round trains its tree on a sample at the front
+			std::vector<int> rows(training_set_ptr->indices_begin(), training_set_ptr->indices_end(rows_to_use));
+			size_t n_sampled_rows = std::max<size_t>(1, static_cast<size_t>(std::round(settings.row_subsample * rows_to_use)));
+			n_sampled_rows = std::min(n_sampled_rows, rows_to_use);
+			// variables considered, of which each tree considers a sample at the front
+			std::vector<int> variables(x_vars_to_use);
+			std::iota(variables.begin(), variables.end(), 0);
+			size_t n_sampled_variables = std::max<size_t>(1, static_cast<size_t>(std::round(settings.col_subsample * x_vars_to_use)));
+			n_sampled_variables = std::min(n_sampled_variables, x_vars_to_use);
+
+			// the initial raw score of every row is the log odds of the positive class in the training rows
+			const uint8_t* labels = training_set_ptr->label_data();
+			double positive_rate = 0.0;
+			for (int row : rows)
+			{
+				positive_rate += labels[row];
+			}
+			positive_rate = std::min(std::max(positive_rate / rows_to_use, 1e-6), 1.0 - 1e-6);
+			base_score = std::log(positive_rate / (1.0 - positive_rate));
+			scores.assign(training_set_ptr->get_n_rows(), base_score);
+			gradients.assign(training_set_ptr->get_n_rows(), 0.0);
+			hessians.assign(training_set_ptr->get_n_rows(), 0.0);
+
+			// for each round
+			trees.assign(settings.n_rounds, {});
+			for (int round = 0; round < settings.n_rounds; round++)
+			{
+				// compute the gradient and hessian of the logistic loss of each training row from its cached raw score
+				for (int row : rows)
+				{
+					double probability = 1.0 / (1.0 + std::exp(-scores[row]));
+					gradients[row] = probability - labels[row];
+					hessians[row] = std::max(probability * (1.0 - probability), 1e-16);
+				}
+
+				// draw the round's samples of rows and variables by shuffling their fronts
+				std::mt19937_64 rng(mix_seed(settings.seed, round));
+				partial_shuffle(rows, n_sampled_rows, rng);
+				partial_shuffle(variables, n_sampled_variables, rng);
+				std::vector<int> round_variables(variables.begin(), variables.begin() + n_sampled_variables);
+				std::sort(round_variables.begin(), round_variables.end());
+
+				// fit the round's tree to the sampled rows, which adds its value to their cached raw scores
+				trees[round].train(*training_set_ptr, gradients.data(), hessians.data(), rows.begin(), rows.begin() + n_sampled_rows,
+					round_variables, settings, scores.data(), thread_pool);
+				// add the tree's value to the cached raw scores of the rows which were not sampled
+				for (size_t i = n_sampled_rows; i < rows_to_use; i++)
+				{
+					scores[rows[i]] += trees[round].predict_binned(*training_set_ptr, rows[i]);
+				}
+			}
+
+			// get end time
+			the_clock::time_point end = the_clock::now();
+
+			// return number of nanoseconds taken
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+		}
+
+
+		// method template for computing the raw score of a sample, i.e. the log odds of the positive class
+		template<typename SampleType>
+		double predict_raw(const SampleType& sample) const
+		{
+			double raw_score = base_score;
+			for (const auto& tree : trees)
+			{
+				raw_score += tree.predict(sample);
+			}
+			return raw_score;
+		}
+
+
+		// method template for making a prediction based on a sample
+		template<typename SampleType>
+		int predict(const SampleType& sample) const
+		{
+			return predict_raw(sample) > 0.0 ? 1 : 0;
+		}
+
+
+		// method template for making predictions for a range of samples, writing them to the given output iterator;
+		// samples are taken in blocks which every tree scores in turn, so that a block stays in cache while each tree
+		// walks it and the raw scores for the block are accumulated in a small array
+		template<typename RowIterator, typename OutputIterator>
+		void predict_batch(RowIterator first, RowIterator last, OutputIterator predictions) const
+		{
+			// raw scores for the current block
+			std::array<double, block_size> raw_scores;
+
+			// for each block of samples
+			while (first != last)
+			{
+				// get the end of the block
+				RowIterator block_end = first;
+				int n_samples = 0;
+				for (; block_end != last && n_samples < block_size; ++block_end, n_samples++)
+				{
+				}
+
+				// add the value of each tree to the raw scores
+				raw_scores.fill(base_score);
+				for (const auto& tree : trees)
+				{
+					int i = 0;
+					for (RowIterator it = first; it != block_end; ++it, i++)
+					{
+						raw_scores[i] += tree.predict(*it);
+					}
+				}
+
+				// output the class whose log odds are positive
+				for (int i = 0; i < n_samples; i++)
+				{
+					*predictions++ = raw_scores[i] > 0.0 ? 1 : 0;
+				}
+				first = block_end;
+			}
+		}
+
+
+		// determine the model's accuracy using the validation set
+		long long validate(uint8_t eighths_rows_to_use)
+		{
+			// number of rows to use
+			size_t rows_to_use = calculate_rows_to_use(8, eighths_rows_to_use, validation_set.size());
+
+			// total correct predictions
+			T total_correct = 0;
+			// column of the validation set holding the dependent variable, which follows the independent variables
+			size_t y_col = validation_set.get_n_x_vars();
+			// model's predictions for the validation set
+			std::vector<int> predictions(validation_set.size());
+
+			// get start time
+			the_clock::time_point start = the_clock::now();
+
+			// get end iterator
+			auto end_iterator = validation_set.begin();
+			std::advance(end_iterator, rows_to_use);
+			// get model's predictions for the samples in the validation set
+			predict_batch(validation_set.begin(), end_iterator, predictions.begin());
+			// for each sample in the validation set
+			for (size_t i = 0; i < rows_to_use; i++)
+			{
+				// add whether prediction is correct to total correct predictions
+				total_correct += (predictions[i] == validation_set[i][y_col]);
+			}
+
+			// get end time
+			the_clock::time_point end = the_clock::now();
+
+			// total correct predictions
+			total_correct = 0;
+
+			// get model's predictions for all the samples in the validation set
+			predict_batch(validation_set.begin(), validation_set.end(), predictions.begin());
+			// for each sample in the validation set
+			for (size_t i = 0; i < validation_set.size(); i++)
+			{
+				// add whether prediction is correct to total correct predictions
+				total_correct += (predictions[i] == validation_set[i][y_col]);
+			}
+
+			// calculate and record validation accuracy
+			validation_accuracy = total_correct / validation_set.size();
+
+			// return number of nanoseconds taken
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+		}
+
+
+		// returns the trees of the model
+		const std::vector<RegressionTree<T, dataset_x_vars>>& get_trees() const
+		{
+			return trees;
+		}
+
+
+		// returns the initial raw score to which each tree's value is added
+		double get_base_score() const
+		{
+			return base_score;
+		}
+
+
+	private:
+
+		// moves a random sample of n elements of a vector to its front by a partial Fisher-Yates shuffle
+		static void partial_shuffle(std::vector<int>& elements, size_t n, std::mt19937_64& rng)
+		{
+			for (size_t i = 0; i < n && i + 1 < elements.size(); i++)
+			{
+				std::uniform_int_distribution<size_t> dist(i, elements.size() - 1);
+				std::swap(elements[i], elements[dist(rng)]);
+			}
+		}
+
+
+		// returns a pointer to the thread pool used for training, which is created on first use, or null to train serially
+		WorkStealingThreadPool* get_thread_pool()
+		{
+			if (settings.n_threads <= 1)
+			{
+				return nullptr;
+			}
+			if (thread_pool_ptr == nullptr || thread_pool_ptr->size() != static_cast<size_t>(settings.n_threads - 1))
+			{
+				thread_pool_ptr.reset(new WorkStealingThreadPool(settings.n_threads - 1));
+			}
+			return thread_pool_ptr.get();
+		}
+
+
+		// number of samples scored by every tree in turn by predict_batch
+		static const int block_size = 256;
+
+		// accuracy of the model on the validation set
+		T validation_accuracy = 0;
+
+		// settings which control how the model is trained
+		GradientBoostingSettings settings;
+
+		// shared pointer to the training set
+		std::shared_ptr<DecisionTreeDataset<T, dataset_x_vars>> training_set_ptr = nullptr;
+		// validation set
+		DecisionTreeDataset<T, dataset_x_vars> validation_set;
+
+		// initial raw score to which each tree's value is added
+		double base_score = 0.0;
+		// trees of the model in the order they were trained
+		std::vector<RegressionTree<T, dataset_x_vars>> trees;
+
+		// cached raw score and the gradient and hessian of the loss of each row of the training set
+		std::vector<double> scores = {};
+		std::vector<double> gradients = {};
+		std::vector<double> hessians = {};
+
+		// thread pool used for training with more than one thread
+		std::unique_ptr<WorkStealingThreadPool> thread_pool_ptr = nullptr;
+
+		// alias for chrono::steady_clock used for performance measurement
+		using the_clock = std::chrono::steady_clock;
+	};
+}
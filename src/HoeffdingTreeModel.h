@@ -0,0 +1,496 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include <array>
+#include <limits>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+
+#include "DecisionTreeDataset.h"
+#include "DecisionTreeSettings.h"
+#include "calculate_rows_to_use.h"
+
+
+namespace MLComparison
+{
+	// class template for a Hoeffding tree prediction model suitable for binary classification, i.e. a decision tree
+	// which learns from a stream of rows, one at a time or in batches, without keeping them; each leaf holds a
+	// summary of the rows which reached it whose size does not depend on how many there were, namely the count,
+	// mean and variance of each variable for each class, and splits once the Hoeffding bound shows that the best
+	// split estimated from its summary beats every other variable's with high probability; a model of dynamic_x_vars
+	// width takes its number of independent variables from its training set
+	template<typename T, size_t dataset_x_vars>
+	class HoeffdingTreeModel
+	{
+	public:
+
+		// default constructor which leaves the tree a single leaf
+		HoeffdingTreeModel()
+		{
+			reset();
+		}
+
+
+		// constructor which takes the names of csv files for the training and validation sets
+		HoeffdingTreeModel(const std::string& train_csv, const std::string& valid_csv) :
+			validation_set(valid_csv)
+		{
+			// construct a new training dataset
+			training_set_ptr.reset(new DecisionTreeDataset<T, dataset_x_vars>);
+			// load training data
+			training_set_ptr->load_data(train_csv);
+			n_x_vars = training_set_ptr->get_n_x_vars();
+			reset();
+		}
+
+
+		// get accuracy
+		T get_accuracy()
+		{
+			return validation_accuracy;
+		}
+
+
+		// get learning settings
+		const HoeffdingTreeSettings& get_settings()
+		{
+			return settings;
+		}
+
+
+		// set learning settings, which apply from the next attempt to split a leaf
+		void set_settings(const HoeffdingTreeSettings& new_settings)
+		{
+			settings = new_settings;
+		}
+
+
+		// loads a csv file as the training set
+		void load_training_set_file(const std::string& csv_file)
+		{
+			training_set_ptr->load_data(csv_file);
+			n_x_vars = training_set_ptr->get_n_x_vars();
+		}
+
+
+		// loads a csv file as the validation set
+		void load_validation_set_file(const std::string& csv_file)
+		{
+			validation_set.load_data(csv_file);
+		}
+
+
+		// discards everything the tree has learnt, leaving a single leaf, and sets the number of fields at the start
+		// of each sample which the tree considers splitting on
+		void reset(size_t x_vars_to_use = std::numeric_limits<size_t>::max())
+		{
+			n_vars = std::min(std::max<size_t>(x_vars_to_use, 1), n_x_vars);
+			nodes.assign(1, { 0, 0, 0, 0, 0, 0 });
+			leaves.assign(1, LeafStats(n_x_vars));
+		}
+
+
+		// trains the model afresh by streaming a certain proportion of the training samples through it in order,
+		// considering a given number of fields within these samples
+		long long train(uint8_t eighths_rows_to_use, size_t x_vars_to_use)
+		{
+			// number of rows to use
+			size_t rows_to_use = calculate_rows_to_use(8, eighths_rows_to_use, training_set_ptr->size());
+			reset(x_vars_to_use);
+
+			// get start time
+			the_clock::time_point start = the_clock::now();
+
+			// learn from each row in turn
+			for (auto it = training_set_ptr->indices_begin(); it != training_set_ptr->indices_end(rows_to_use); ++it)
+			{
+				const auto& row = (*training_set_ptr)[*it];
+				learn(row, static_cast<int>(row[n_x_vars]));
+			}
+
+			// get end time
+			the_clock::time_point end = the_clock::now();
+
+			// return number of nanoseconds taken
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+		}
+
+
+		// method template for learning from a sample of a known class, which updates the summary of the leaf the
+		// sample reaches and attempts to split that leaf once it has learnt from another grace period of rows
+		template<typename SampleType>
+		void learn(const SampleType& sample, int class_val)
+		{
+			int node_index = find_leaf(sample);
+			int class_index = class_val != 0;
+			LeafStats& leaf = leaves[nodes[node_index].leaf];
+
+			// add the sample to the leaf's summary
+			leaf.class_counts[class_index] += 1.0;
+			leaf.n_learnt[class_index] += 1.0;
+			for (size_t var = 0; var < n_vars; var++)
+			{
+				leaf.variables[var].add(static_cast<double>(sample[var]), class_index);
+			}
+			nodes[node_index].class_prediction = leaf.class_counts[1] > leaf.class_counts[0] ? 1 : 0;
+
+			// attempt to split the leaf once every grace period
+			double n_learnt = leaf.n_learnt[0] + leaf.n_learnt[1];
+			if (n_learnt - leaf.n_learnt_at_last_attempt >= settings.grace_period)
+			{
+				leaf.n_learnt_at_last_attempt = n_learnt;
+				attempt_split(node_index);
+			}
+		}
+
+
+		// method template for learning from a range of samples in turn, where the class of each sample follows its
+		// variables, as in the rows of a dataset
+		template<typename RowIterator>
+		void learn_batch(RowIterator first, RowIterator last)
+		{
+			for (; first != last; ++first)
+			{
+				learn(*first, static_cast<int>((*first)[n_x_vars]));
+			}
+		}
+
+
+		// method template for making a prediction based on a sample, which is the class most prevalent in the leaf
+		// it reaches
+		template<typename SampleType>
+		int predict(const SampleType& sample) const
+		{
+			return nodes[find_leaf(sample)].class_prediction;
+		}
+
+
+		// method template for making predictions for a range of samples, writing them to the given output iterator
+		template<typename RowIterator, typename OutputIterator>
+		void predict_batch(RowIterator first, RowIterator last, OutputIterator predictions) const
+		{
+			for (; first != last; ++first)
+			{
+				*predictions++ = predict(*first);
+			}
+		}
+
+
+		// determine the model's accuracy using the validation set
+		long long validate(uint8_t eighths_rows_to_use)
+		{
+			// number of rows to use
+			size_t rows_to_use = calculate_rows_to_use(8, eighths_rows_to_use, validation_set.size());
+
+			// total correct predictions
+			T total_correct = 0;
+			// column of the validation set holding the dependent variable, which follows the independent variables
+			size_t y_col = validation_set.get_n_x_vars();
+			// model's predictions for the validation set
+			std::vector<int> predictions(validation_set.size());
+
+			// get start time
+			the_clock::time_point start = the_clock::now();
+
+			// get end iterator
+			auto end_iterator = validation_set.begin();
+			std::advance(end_iterator, rows_to_use);
+			// get model's predictions for the samples in the validation set
+			predict_batch(validation_set.begin(), end_iterator, predictions.begin());
+			// for each sample in the validation set
+			for (size_t i = 0; i < rows_to_use; i++)
+			{
+				// add whether prediction is correct to total correct predictions
+				total_correct += (predictions[i] == validation_set[i][y_col]);
+			}
+
+			// get end time
+			the_clock::time_point end = the_clock::now();
+
+			// total correct predictions
+			total_correct = 0;
+
+			// get model's predictions for all the samples in the validation set
+			predict_batch(validation_set.begin(), validation_set.end(), predictions.begin());
+			// for each sample in the validation set
+			for (size_t i = 0; i < validation_set.size(); i++)
+			{
+				// add whether prediction is correct to total correct predictions
+				total_correct += (predictions[i] == validation_set[i][y_col]);
+			}
+
+			// calculate and record validation accuracy
+			validation_accuracy = total_correct / validation_set.size();
+
+			// return number of nanoseconds taken
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+		}
+
+
+		// returns the number of nodes in the tree
+		size_t size() const
+		{
+			return nodes.size();
+		}
+
+
+		// returns the number of leaves in the tree
+		size_t get_n_leaves() const
+		{
+			return leaves.size();
+		}
+
+
+	private:
+
+		// struct for the count, mean and sum of squared deviations from the mean of a variable's values,
+		// which are updated one value at a time by Welford's method
+		struct GaussianEstimator
+		{
+			double count = 0.0;
+			double mean = 0.0;
+			double m2 = 0.0;
+
+
+			// adds a value to the estimate
+			void add(double value)
+			{
+				count += 1.0;
+				double delta = value - mean;
+				mean += delta / count;
+				m2 += delta * (value - mean);
+			}
+
+
+			// returns the estimated number of the values below the given threshold, assuming they are normally distributed
+			double count_below(double threshold) const
+			{
+				double variance = count > 1.0 ? m2 / (count - 1.0) : 0.0;
+				if (variance <= 0.0)
+				{
+					return mean < threshold ? count : 0.0;
+				}
+				return count * 0.5 * std::erfc((mean - threshold) / std::sqrt(2.0 * variance));
+			}
+		};
+
+
+		// struct for the summary of a variable's values in the rows a leaf has learnt from
+		struct VariableStats
+		{
+			// range of the values, between which split points are evaluated
+			double min_val = std::numeric_limits<double>::infinity();
+			double max_val = -std::numeric_limits<double>::infinity();
+			// distribution of the values of each class
+			std::array<GaussianEstimator, 2> classes;
+
+
+			// adds a value of a row of the given class to the summary
+			void add(double value, int class_index)
+			{
+				min_val = std::min(min_val, value);
+				max_val = std::max(max_val, value);
+				classes[class_index].add(value);
+			}
+		};
+
+
+		// whether the number of independent variables is read from the training set's csv file
+		static const bool is_dynamic = dataset_x_vars == dynamic_x_vars;
+		// alias for the summaries of a leaf's variables, an array unless the number of independent variables is dynamic
+		using VariableStatsArray = typename std::conditional<is_dynamic, std::vector<VariableStats>, std::array<VariableStats, (is_dynamic ? 1 : dataset_x_vars)>>::type;
+
+
+		// returns the summaries of the variables of a new leaf for a model of fixed width
+		static VariableStatsArray make_variables(size_t, std::false_type)
+		{
+			return VariableStatsArray();
+		}
+
+
+		// returns the summaries of the given number of variables of a new leaf for a model of dynamic width
+		static VariableStatsArray make_variables(size_t n_variables, std::true_type)
+		{
+			return VariableStatsArray(n_variables);
+		}
+
+
+		// struct for the summary of the rows a leaf has learnt from
+		struct LeafStats
+		{
+			// constructor which creates summaries of the given number of variables and starts the class counts from
+			// which the leaf predicts at the given estimate
+			LeafStats(size_t n_variables, const std::array<double, 2>& initial_class_counts = { { 0.0, 0.0 } }) :
+				class_counts(initial_class_counts),
+				variables(make_variables(n_variables, std::integral_constant<bool, is_dynamic>()))
+			{
+			}
+
+
+			// class counts from which the leaf predicts, which start from the counts its parent's split was estimated to
+			// send it, so that a new leaf predicts sensibly before it has learnt from any rows
+			std::array<double, 2> class_counts;
+			// number of rows of each class the leaf has learnt from, which its variables' summaries describe
+			std::array<double, 2> n_learnt = { { 0.0, 0.0 } };
+			// number of rows the leaf had learnt from at its last attempt to split
+			double n_learnt_at_last_attempt = 0.0;
+			// summary of each variable
+			VariableStatsArray variables;
+		};
+
+
+		// struct for a node of the tree, where each node's children are next to each other
+		struct Node
+		{
+			// split value, compared against the sample's value of the split variable
+			T split_val;
+			// index of the left child node, whose sibling is the right child node at the next index,
+			// or 0 if the node is a leaf
+			int left;
+			// index of the leaf's summary if the node is a leaf
+			int leaf;
+			// depth of the node
+			int depth;
+			// split variable if the node is not a leaf
+			int split_var;
+			// class prediction if the node is a leaf
+			int class_prediction;
+		};
+
+
+		// method template for finding the index of the leaf a sample reaches
+		template<typename SampleType>
+		int find_leaf(const SampleType& sample) const
+		{
+			int i = 0;
+			while (nodes[i].left != 0)
+			{
+				const Node& node = nodes[i];
+				i = node.left + !(sample[node.split_var] < node.split_val);
+			}
+			return i;
+		}
+
+
+		// splits the leaf at the given index if the Hoeffding bound shows, with probability 1 - split_confidence,
+		// that the variable of the best split estimated from its summary is better than every other variable, or
+		// if the best splits of the two best variables are too close for the rows still to come to tell apart
+		void attempt_split(int node_index)
+		{
+			const LeafStats& leaf = leaves[nodes[node_index].leaf];
+			double n_learnt = leaf.n_learnt[0] + leaf.n_learnt[1];
+
+			// a pure leaf does not split, nor does any leaf at the maximum depth or once the tree has the maximum number of leaves
+			if (leaf.n_learnt[0] == 0.0 || leaf.n_learnt[1] == 0.0 || nodes[node_index].depth >= settings.max_depth
+				|| leaves.size() >= static_cast<size_t>(settings.max_leaves))
+			{
+				return;
+			}
+
+			// find the best split of each variable among evenly spaced thresholds in the range of its values, from the
+			// number of rows of each class estimated to fall below each threshold, and keep the best two variables' splits
+			double parent_impurity = gini_impurity(leaf.n_learnt);
+			int best_var = -1;
+			double best_val = 0.0;
+			double best_gain = 0.0;
+			double second_best_gain = 0.0;
+			std::array<double, 2> best_left_counts = { { 0.0, 0.0 } };
+			for (size_t var = 0; var < n_vars; var++)
+			{
+				const VariableStats& stats = leaf.variables[var];
+				double var_best_gain = 0.0;
+				for (int point = 1; point <= settings.n_split_points && stats.min_val < stats.max_val; point++)
+				{
+					double split_val = stats.min_val + (stats.max_val - stats.min_val) * point / (settings.n_split_points + 1);
+					std::array<double, 2> left_counts = { { stats.classes[0].count_below(split_val), stats.classes[1].count_below(split_val) } };
+					std::array<double, 2> right_counts = { { leaf.n_learnt[0] - left_counts[0], leaf.n_learnt[1] - left_counts[1] } };
+					double n_left = left_counts[0] + left_counts[1];
+					double n_right = right_counts[0] + right_counts[1];
+					if (n_left <= 0.0 || n_right <= 0.0)
+					{
+						continue;
+					}
+					double gain = parent_impurity - (n_left * gini_impurity(left_counts) + n_right * gini_impurity(right_counts)) / n_learnt;
+					if (gain > var_best_gain)
+					{
+						var_best_gain = gain;
+						if (gain > best_gain)
+						{
+							best_var = static_cast<int>(var);
+							best_val = split_val;
+							best_left_counts = left_counts;
+						}
+					}
+				}
+				if (var_best_gain > best_gain)
+				{
+					second_best_gain = best_gain;
+					best_gain = var_best_gain;
+				}
+				else
+				{
+					second_best_gain = std::max(second_best_gain, var_best_gain);
+				}
+			}
+
+			// the Hoeffding bound on the difference between the mean Gini reduction of the rows learnt from and that of
+			// the whole stream, where the reduction in Gini impurity of two classes lies between 0 and 0.5
+			const double gain_range = 0.5;
+			double epsilon = std::sqrt(gain_range * gain_range * std::log(1.0 / settings.split_confidence) / (2.0 * n_learnt));
+			if (best_var < 0 || (best_gain - second_best_gain <= epsilon && epsilon >= settings.tie_threshold))
+			{
+				return;
+			}
+
+			// split the leaf, whose summary is reused by its left child, with each child starting from the class counts
+			// the split was estimated to send it
+			std::array<double, 2> best_right_counts = { { leaf.n_learnt[0] - best_left_counts[0], leaf.n_learnt[1] - best_left_counts[1] } };
+			int leaf_index = nodes[node_index].leaf;
+			int depth = nodes[node_index].depth;
+			int left_index = static_cast<int>(nodes.size());
+			nodes[node_index] = { static_cast<T>(best_val), left_index, 0, depth, best_var, 0 };
+			nodes.push_back({ 0, 0, leaf_index, depth + 1, 0, best_left_counts[1] > best_left_counts[0] ? 1 : 0 });
+			nodes.push_back({ 0, 0, static_cast<int>(leaves.size()), depth + 1, 0, best_right_counts[1] > best_right_counts[0] ? 1 : 0 });
+			leaves[leaf_index] = LeafStats(n_x_vars, best_left_counts);
+			leaves.push_back(LeafStats(n_x_vars, best_right_counts));
+		}
+
+
+		// returns the Gini impurity of a group with the given class counts
+		static double gini_impurity(const std::array<double, 2>& class_counts)
+		{
+			double n = class_counts[0] + class_counts[1];
+			double p = class_counts[1] / n;
+			return 2.0 * p * (1.0 - p);
+		}
+
+
+		// accuracy of the model on the validation set
+		T validation_accuracy = 0;
+
+		// settings which control how the tree learns
+		HoeffdingTreeSettings settings;
+
+		// shared pointer to the training set
+		std::shared_ptr<DecisionTreeDataset<T, dataset_x_vars>> training_set_ptr = nullptr;
+		// validation set
+		DecisionTreeDataset<T, dataset_x_vars> validation_set;
+
+		// number of independent variables in each sample, which a model of dynamic width reads from its training set
+		size_t n_x_vars = dataset_x_vars;
+		// number of fields at the start of each sample which the tree considers splitting on
+		size_t n_vars = dataset_x_vars;
+		// nodes of the tree, where the root node is the first
+		std::vector<Node> nodes = {};
+		// summary of each leaf, indexed by the leaves' nodes
+		std::vector<LeafStats> leaves = {};
+
+		// alias for chrono::steady_clock used for performance measurement
+		using the_clock = std::chrono::steady_clock;
+	};
+}
@@ -8,10 +8,10 @@
 
 namespace MLComparison
 {
-	// class template for a standard linear neural network layer
-	// with a given number of inputs and units (neurons)
-	template<typename T, int n_inputs, int n_units>
-	class Linear : public TrainableLayer<T, n_inputs, n_units>
+	// class template for a standard linear neural network layer with a given number of inputs and units (neurons),
+	// whose inputs have a row for each sample of a mini-batch of the given size
+	template<typename T, int n_inputs, int n_units, size_t batch_size = 1>
+	class Linear : public TrainableLayer<T, n_inputs, n_units, batch_size>
 	{
 	public:
 
@@ -23,7 +23,7 @@ namespace MLComparison
 
 
 		// constructor which additionally sets the learning rate
-		Linear(T learning_rate) : TrainableLayer<T, n_inputs, n_units>(learning_rate)
+		Linear(T learning_rate) : TrainableLayer<T, n_inputs, n_units, batch_size>(learning_rate)
 		{
 		}
 
@@ -49,22 +49,31 @@ namespace MLComparison
 
 
 		// performs the forward pass, calculating outputs based on the inputs, weights and biases
-		virtual Matrix<T, 1, n_units>* operator()(Matrix<T, 1, n_inputs>* x) override
+		virtual Matrix<T, batch_size, n_units>* operator()(Matrix<T, batch_size, n_inputs>* x) override
 		{
 			// save pointer to the input matrix so its gradients can be set during the backward pass
 			forward_record.input_matrix = x;
-			// output matrix is the biases added to the dot product of input matrix and weights, 
-			// i.e the output of each unit is the sum of each input multiplied by that unit's corresponding
-			// weight parameter, plus the bias terms
-			forward_record.output_matrix = x->dot(weights).add(biases);
+			// output matrix is the biases added to each row of the dot product of input matrix and weights,
+			// i.e the output of each unit for each sample is the sum of each input multiplied by that unit's
+			// corresponding weight parameter, plus the bias terms
+			forward_record.output_matrix = x->dot(weights).add_to_each_row(biases);
 			// return the outputs
 			return &forward_record.output_matrix;
 		}
 
 
 		// performs the backwards pass, calculating the gradients of the input matrix and the parameters
-		// based on the gradients of the output matrix and the derivative of the current function
+		// based on the gradients of the output matrix and the derivative of the current function, where
+		// the gradients of the input matrix are only calculated if it is gradient-enabled
 		virtual void backward() override
+		{
+			backward(dynamic_cast<GradMatrix<T, batch_size, n_inputs>*>(forward_record.input_matrix));
+		}
+
+
+		// performs the backwards pass given the input matrix of the forward pass as a gradient-enabled matrix, or
+		// a null pointer if its gradients are not needed, which avoids checking its type at run time
+		void backward(GradMatrix<T, batch_size, n_inputs>* grad_input_ptr)
 		{
 			// if input matrix exists
 			if (forward_record.input_matrix != nullptr)
@@ -72,16 +81,17 @@ namespace MLComparison
 				// gradients of the input matrix are the dot product of the gradients of the output matrix and the
 				// transpose of the weights, i.e the gradient of an input element is the sum of the elementwise
 				// product of the gradients of each neuron's output and the weights of each neuron for that input
-				if (auto* ptr = dynamic_cast<GradMatrix<T, 1, n_inputs>*>(forward_record.input_matrix))
+				if (grad_input_ptr != nullptr)
 				{
-					ptr->grad = forward_record.output_matrix.grad.dot_t(weights);
+					grad_input_ptr->grad = forward_record.output_matrix.grad.dot_t(weights);
 				}
 				// gradients of the weights are the dot product of the transpose of the input matrix and the gradients
 				// of the output matrix, i.e. the gradient of each weight is the product of the input corresponding to
-				// that weight and the gradient of the output of the unit to which that weight belongs
+				// that weight and the gradient of the output of the unit to which that weight belongs, summed over
+				// the batch's samples, whose output gradients the loss has already divided by their number
 				weights.grad = forward_record.input_matrix->t_dot(forward_record.output_matrix.grad);
-				// gradients of the biases are simply the gradients of the outputs
-				biases.grad = forward_record.output_matrix.grad;
+				// gradients of the biases are the gradients of the outputs summed over the batch's samples
+				biases.grad = forward_record.output_matrix.grad.sum_rows();
 			}
 		}
 
@@ -94,10 +104,24 @@ namespace MLComparison
 		}
 
 
+		// getter for the matrix of weights, with a row for each input and a column for each unit
+		const Matrix<T, n_inputs, n_units>& get_weights() const
+		{
+			return weights;
+		}
+
+
+		// getter for the matrix of biases
+		const Matrix<T, 1, n_units>& get_biases() const
+		{
+			return biases;
+		}
+
+
 	private:
 
 		// record of forward pass
-		ForwardRecord<T, n_inputs, n_units> forward_record;
+		ForwardRecord<T, n_inputs, n_units, batch_size> forward_record;
 
 		// matrix of weights
 		GradMatrix<T, n_inputs, n_units> weights;
@@ -7,28 +7,43 @@
 
 namespace MLComparison
 {
-	// class template for mean squared error (MSE) loss function layer
-	template<typename T>
-	class MSELoss : public LossLayer<T>
+	// class template for mean squared error (MSE) loss function layer, averaged over the samples of a mini-batch
+	template<typename T, size_t batch_size = 1>
+	class MSELoss : public LossLayer<T, batch_size>
 	{
 	public:
 
-		// forward pass which calculates and returns the mean squared error
-		virtual T operator()(Matrix<T, 1, 1>* x, T target) override
+		// call operator which takes a single target number
+		using LossLayer<T, batch_size>::operator();
+
+
+		// forward pass which calculates and returns the mean squared error over the rows which are samples
+		virtual T operator()(Matrix<T, batch_size, 1>* x, const std::array<T, batch_size>& batch_targets, int batch_n_samples) override
 		{
-			// save pointer to input matrix
+			// save pointer to input matrix, the targets and the number of samples
 			this->input_matrix = x;
-			this->target = target;
+			this->targets = batch_targets;
+			this->n_samples = batch_n_samples;
 			// calculate and return loss
-			return (x->at(0)[0] - target) * (x->at(0)[0] - target);
+			T total_loss = 0;
+			for (int row = 0; row < batch_n_samples; row++)
+			{
+				total_loss += (x->at(row)[0] - batch_targets[row]) * (x->at(row)[0] - batch_targets[row]);
+			}
+			return total_loss / batch_n_samples;
 		}
 
 
 		// backward pass which sets the gradients of the input matrix
 		void backward() override
 		{
-			// gradient of input is 2 * error
-			static_cast<GradMatrix<T, 1, 1>*>(this->input_matrix)->grad[0][0] = 2 * (this->input_matrix->at(0)[0] - this->target);
+			// gradient of each sample's input is 2 * error, divided by the number of samples as the loss is their mean,
+			// and the gradient of each padding row is 0, so that it adds nothing to the gradients of the parameters
+			auto* grad_input_ptr = static_cast<GradMatrix<T, batch_size, 1>*>(this->input_matrix);
+			for (int row = 0; row < static_cast<int>(batch_size); row++)
+			{
+				grad_input_ptr->grad[row][0] = row < this->n_samples ? 2 * (this->input_matrix->at(row)[0] - this->targets[row]) / this->n_samples : 0;
+			}
 		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace MLComparison
+{
+#ifdef _WIN32
+	// constructor which maps the file with the given name, throwing std::runtime_error if it cannot be opened
+	// or mapped, which includes an empty file
+	MappedFile::MappedFile(const std::string& file_name)
+	{
+		// open the file and get its size
+		file_handle = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file_handle == INVALID_HANDLE_VALUE)
+		{
+			file_handle = nullptr;
+			throw std::runtime_error("MappedFile: cannot open " + file_name);
+		}
+		LARGE_INTEGER file_size;
+		if (!GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart == 0)
+		{
+			CloseHandle(file_handle);
+			throw std::runtime_error("MappedFile: cannot map empty or unreadable file " + file_name);
+		}
+
+		// map the whole file read-only
+		mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		void* view = mapping_handle != nullptr ? MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+		if (view == nullptr)
+		{
+			if (mapping_handle != nullptr)
+			{
+				CloseHandle(mapping_handle);
+			}
+			CloseHandle(file_handle);
+			throw std::runtime_error("MappedFile: cannot map " + file_name);
+		}
+		mapped_data = static_cast<const unsigned char*>(view);
+		mapped_size = static_cast<size_t>(file_size.QuadPart);
+	}
+
+
+	// destructor which unmaps the file
+	MappedFile::~MappedFile()
+	{
+		UnmapViewOfFile(mapped_data);
+		CloseHandle(mapping_handle);
+		CloseHandle(file_handle);
+	}
+#else
+	// constructor which maps the file with the given name, throwing std::runtime_error if it cannot be opened
+	// or mapped, which includes an empty file
+	MappedFile::MappedFile(const std::string& file_name)
+	{
+		// open the file and get its size
+		int fd = open(file_name.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			throw std::runtime_error("MappedFile: cannot open " + file_name);
+		}
+		struct stat file_status;
+		if (fstat(fd, &file_status) != 0 || file_status.st_size == 0)
+		{
+			close(fd);
+			throw std::runtime_error("MappedFile: cannot map empty or unreadable file " + file_name);
+		}
+
+		// map the whole file read-only, after which the descriptor is no longer needed
+		void* view = mmap(nullptr, static_cast<size_t>(file_status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (view == MAP_FAILED)
+		{
+			throw std::runtime_error("MappedFile: cannot map " + file_name);
+		}
+		mapped_data = static_cast<const unsigned char*>(view);
+		mapped_size = static_cast<size_t>(file_status.st_size);
+	}
+
+
+	// destructor which unmaps the file
+	MappedFile::~MappedFile()
+	{
+		munmap(const_cast<unsigned char*>(mapped_data), mapped_size);
+	}
+#endif
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+
+namespace MLComparison
+{
+	// class for a read-only memory mapping of a whole file, which is unmapped when the object is destroyed
+	class MappedFile
+	{
+	public:
+
+		// constructor which maps the file with the given name, throwing std::runtime_error if it cannot be opened
+		// or mapped, which includes an empty file
+		explicit MappedFile(const std::string& file_name);
+
+
+		// destructor which unmaps the file
+		~MappedFile();
+
+
+		// the mapping is released by the destructor, so the object is neither copyable nor assignable
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+
+		// returns a pointer to the first byte of the file, which is aligned to a page boundary
+		const unsigned char* data() const
+		{
+			return mapped_data;
+		}
+
+
+		// returns the size of the file in bytes
+		size_t size() const
+		{
+			return mapped_size;
+		}
+
+
+	private:
+
+		// first byte and size of the mapping
+		const unsigned char* mapped_data = nullptr;
+		size_t mapped_size = 0;
+
+#ifdef _WIN32
+		// handles of the file and its mapping
+		void* file_handle = nullptr;
+		void* mapping_handle = nullptr;
+#endif
+	};
+}
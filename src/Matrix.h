@@ -2,6 +2,9 @@
 
 #include <array>
 #include <iostream>
+#include <type_traits>
+
+#include "gemm.h"
 
 
 namespace MLComparison
@@ -93,16 +96,23 @@ namespace MLComparison
 			// create a result matrix
 			Matrix<T, n_rows, right_cols> result;
 
+			// large products are calculated by the blocked kernels
+			if (use_blocked_kernels(n_rows, right_cols, n_cols))
+			{
+				multiply_blocked(GemmOperation::a_b, n_rows, right_cols, n_cols, &data[0][0], &rhs[0][0], &result[0][0],
+					std::integral_constant<bool, is_gemm_type>());
+				return result;
+			}
+
 			// for each row of the result
 			for (int row = 0; row < n_rows; row++)
 			{
-				// for each column of the result
-				for (int col = 0; col < right_cols; col++)
+				// item is sum of elementwise product of corresponding row of current matrix and
+				// corresponding column of matrix given as argument, accumulated for every column
+				// at once so that the rows of the matrix given as argument are read contiguously
+				for (int k = 0; k < n_cols; k++)
 				{
-					// item is sum of elementwise product
-					// of corresponding row of current matrix 
-					// and corresponding column of matrix given as argument
-					for (int k = 0; k < n_cols; k++)
+					for (int col = 0; col < right_cols; col++)
 					{
 						result[row][col] += data[row][k] * rhs[k][col];
 					}
@@ -122,16 +132,22 @@ namespace MLComparison
 			// create a result matrix
 			Matrix<T, n_cols, right_cols> result;
 
-			// for each row of the result
-			for (int row = 0; row < n_cols; row++)
+			// large products are calculated by the blocked kernels
+			if (use_blocked_kernels(n_cols, right_cols, n_rows))
 			{
-				// for each column of the result
-				for (int col = 0; col < right_cols; col++)
+				multiply_blocked(GemmOperation::at_b, n_cols, right_cols, n_rows, &data[0][0], &rhs[0][0], &result[0][0],
+					std::integral_constant<bool, is_gemm_type>());
+				return result;
+			}
+
+			// item is sum of elementwise product of corresponding row of transpose of current matrix
+			// and corresponding column of matrix given as argument, accumulated for every item at
+			// once so that the rows of both matrices are read contiguously
+			for (int k = 0; k < n_rows; k++)
+			{
+				for (int row = 0; row < n_cols; row++)
 				{
-					// item is sum of elementwise product
-					// of corresponding row of transpose of current matrix
-					// and corresponding column of matrix given as argument
-					for (int k = 0; k < n_rows; k++)
+					for (int col = 0; col < right_cols; col++)
 					{
 						result[row][col] += data[k][row] * rhs[k][col];
 					}
@@ -151,6 +167,14 @@ namespace MLComparison
 			// create a result matrix
 			Matrix<T, n_rows, right_rows> result;
 
+			// large products are calculated by the blocked kernels
+			if (use_blocked_kernels(n_rows, right_rows, n_cols))
+			{
+				multiply_blocked(GemmOperation::a_bt, n_rows, right_rows, n_cols, &data[0][0], &rhs[0][0], &result[0][0],
+					std::integral_constant<bool, is_gemm_type>());
+				return result;
+			}
+
 			// for each row of the result
 			for (int row = 0; row < n_rows; row++)
 			{
@@ -172,6 +196,40 @@ namespace MLComparison
 		}
 
 
+		// method template which adds the dot product of the transpose of a given (possibly gradient-enabled) matrix
+		// and another, multiplied by a scale, to the current matrix without storing the dot product, such as a step of
+		// gradient descent whose gradients are such a dot product, taken with the negative of the learning rate
+		template<template<typename, size_t, size_t> class LeftMatrixType, template<typename, size_t, size_t> class RightMatrixType, size_t shared_rows>
+		void add_scaled_t_dot(double scale, const LeftMatrixType<T, shared_rows, n_rows>& lhs, const RightMatrixType<T, shared_rows, n_cols>& rhs)
+		{
+			// large products are calculated and added by the blocked kernels
+			if (use_blocked_kernels(n_rows, n_cols, shared_rows))
+			{
+				multiply_add_blocked(GemmOperation::at_b, n_rows, n_cols, shared_rows, static_cast<T>(scale), &lhs[0][0], &rhs[0][0], &data[0][0],
+					std::integral_constant<bool, is_gemm_type>());
+				return;
+			}
+
+			// for each row of the current matrix, calculate the corresponding row of the dot product, accumulated over
+			// the rows of both given matrices, and add it multiplied by the scale
+			for (int row = 0; row < n_rows; row++)
+			{
+				std::array<T, n_cols> product_row = {};
+				for (int k = 0; k < shared_rows; k++)
+				{
+					for (int col = 0; col < n_cols; col++)
+					{
+						product_row[col] += lhs[k][row] * rhs[k][col];
+					}
+				}
+				for (int col = 0; col < n_cols; col++)
+				{
+					data[row][col] += scale * product_row[col];
+				}
+			}
+		}
+
+
 		// method template which adds the elements of the given 
 		// (possibly gradient-enabled) matrix to the current matrix
 		template<template<typename, size_t, size_t> class MatrixType>
@@ -205,6 +263,46 @@ namespace MLComparison
 		}
 
 
+		// method template which creates and returns a new matrix whose rows are the sum of those in the current
+		// matrix and the given (possibly gradient-enabled) row matrix, i.e. which adds the row to each row
+		template<template<typename, size_t, size_t> class MatrixType>
+		Matrix<T, n_rows, n_cols> add_to_each_row(const MatrixType<T, 1, n_cols>& rhs) const
+		{
+			// copy the current matrix
+			Matrix<T, n_rows, n_cols> result = *this;
+			// add the given row to each row of this copy
+			for (int row = 0; row < n_rows; row++)
+			{
+				for (int col = 0; col < n_cols; col++)
+				{
+					result[row][col] += rhs[0][col];
+				}
+			}
+			// return the result
+			return result;
+		}
+
+
+		// returns a row matrix whose elements are the sums of the columns of the current matrix
+		Matrix<T, 1, n_cols> sum_rows() const
+		{
+			// create a matrix to store the result
+			Matrix<T, 1, n_cols> result;
+
+			// add each row of the current matrix to the result
+			for (int row = 0; row < n_rows; row++)
+			{
+				for (int col = 0; col < n_cols; col++)
+				{
+					result[0][col] += data[row][col];
+				}
+			}
+
+			// return the result
+			return result;
+		}
+
+
 		// returns the transpose of the current matrix
 		Matrix<T, n_cols, n_rows> t() const
 		{
@@ -245,5 +343,51 @@ namespace MLComparison
 
 		// two-dimensional array holding the data
 		std::array<std::array<T, n_cols>, n_rows> data;
+
+
+	private:
+
+		// whether products of matrices of the element type can be calculated by the blocked kernels
+		static constexpr bool is_gemm_type = std::is_same<T, float>::value || std::is_same<T, double>::value;
+
+
+		// returns whether a product of an m by k matrix and a k by n matrix is calculated by the blocked kernels,
+		// which is only faster than the simple loops once it has several rows and enough multiplications to
+		// amortize the packing of its operands; products with a single row, such as the forward pass of a
+		// layer for one sample, are left to the simple loops
+		static constexpr bool use_blocked_kernels(size_t m, size_t n, size_t k)
+		{
+			return is_gemm_type && m >= 8 && m * n * k >= 32768;
+		}
+
+
+		// calculates a product using the blocked kernels, which read the rows of each matrix as one contiguous array
+		static void multiply_blocked(GemmOperation operation, size_t m, size_t n, size_t k, const T* a, const T* b, T* c,
+			std::true_type)
+		{
+			static_assert(sizeof(std::array<T, n_cols>) == n_cols * sizeof(T), "rows of a matrix must be contiguous");
+			gemm(operation, m, n, k, a, b, c);
+		}
+
+
+		// overload for element types the blocked kernels do not support, for which the simple loops are always used
+		static void multiply_blocked(GemmOperation, size_t, size_t, size_t, const T*, const T*, T*, std::false_type)
+		{
+		}
+
+
+		// adds a product multiplied by alpha to a matrix using the blocked kernels
+		static void multiply_add_blocked(GemmOperation operation, size_t m, size_t n, size_t k, T alpha, const T* a, const T* b, T* c,
+			std::true_type)
+		{
+			static_assert(sizeof(std::array<T, n_cols>) == n_cols * sizeof(T), "rows of a matrix must be contiguous");
+			gemm_accumulate(operation, m, n, k, alpha, a, b, c);
+		}
+
+
+		// overload for element types the blocked kernels do not support
+		static void multiply_add_blocked(GemmOperation, size_t, size_t, size_t, T, const T*, const T*, T*, std::false_type)
+		{
+		}
 	};
 }
\ No newline at end of file
@@ -1,71 +1,205 @@
 #pragma once
 
+#include <string>
+#include <stdexcept>
+
 #include "base_layers.h"
 #include "Linear.h"
 #include "Relu.h"
 #include "Sigmoid.h"
+#include "FusedLinear.h"
+#include "Sequential.h"
+#include "DynamicLinear.h"
+#include "dispatch_x_vars.h"
+#include "export_header.h"
 
 
 namespace MLComparison
 {
-	// class template for a simple artificial neural network suitable for binary classification
-	template<typename T, size_t input_cols>
-	class NeuralNet : public TrainableLayer<T, input_cols, 1>
+	// class template for a simple artificial neural network suitable for binary classification, which takes a mini-batch
+	// of samples of the given size at a time, with a row of its inputs and outputs for each; its layers are a Sequential
+	// network, so that its forward and backward passes make no virtual calls or run-time type checks, of linear layers
+	// fused with their activation functions, which update their parameters in their backward passes
+	template<typename T, size_t input_cols, size_t batch_size = 1>
+	class NeuralNet : public TrainableLayer<T, input_cols, 1, batch_size>
 	{
+		static_assert(input_cols != dynamic_x_vars, "networks of dynamic width take one sample at a time");
+
 	public:
 
 		// constructor which takes a learning rate
-		NeuralNet(T learning_rate) : TrainableLayer<T, input_cols, 1>(learning_rate), linear_layer_1(learning_rate), linear_layer_2(learning_rate)
+		NeuralNet(T learning_rate) : TrainableLayer<T, input_cols, 1, batch_size>(learning_rate), layers(learning_rate)
 		{
 			// initialize weights of each linear layer
-			linear_layer_1.kaiming_he_init();
-			linear_layer_2.kaiming_he_init();
+			layers.template get<0>().kaiming_he_init();
+			layers.template get<1>().kaiming_he_init();
+		}
+
+
+		// constructor which creates a replica of a network, with its own records of the forward and backward passes,
+		// which trains the parameters of the original network without locks
+		NeuralNet(NeuralNet& shared_network, SharedParametersTag tag) :
+			TrainableLayer<T, input_cols, 1, batch_size>(shared_network.learning_rate),
+			layers(shared_network.layers, tag)
+		{
+		}
+
+
+		// call operator which performs the forward pass
+		virtual Matrix<T, batch_size, 1>* operator()(Matrix<T, batch_size, input_cols>* x) override final
+		{
+			return layers(x);
+		}
+
+
+		// backward pass, which does not calculate the gradients of the inputs
+		virtual void backward() override final
+		{
+			layers.backward();
+		}
+
+
+		// backward pass given the input matrix of the forward pass as a gradient-enabled matrix, whose gradients are set
+		void backward(GradMatrix<T, batch_size, input_cols>* grad_input_ptr)
+		{
+			layers.backward(grad_input_ptr);
+		}
+
+
+		// updates the parameters of both linear layers, which their backward passes have already done
+		virtual void update() override final
+		{
+			layers.update();
+		}
+
+
+		// sets the learning rate
+		virtual void set_lr(T new_learning_rate) override final
+		{
+			this->learning_rate = new_learning_rate;
+			layers.set_lr(new_learning_rate);
+		}
+
+
+		// exports the network as a self-contained C++ header defining a function template of the given name, with the
+		// weights as constants and the dot products unrolled
+		void export_header(const std::string& file_name, const std::string& function_name) const
+		{
+			const auto& linear_layer_1 = layers.template get<0>();
+			const auto& linear_layer_2 = layers.template get<1>();
+			export_network_header<T>(file_name, function_name, static_cast<int>(input_cols), 8, &linear_layer_1.get_weights()[0][0],
+				&linear_layer_1.get_biases()[0][0], &linear_layer_2.get_weights()[0][0], linear_layer_2.get_biases()[0][0]);
+		}
+
+
+	private:
+
+		// first linear layer with 8 units (neurons) and a relu activation function, and second linear
+		// layer with a single unit and a sigmoid activation function
+		Sequential<LinearRelu<T, input_cols, 8, batch_size>, LinearSigmoid<T, 8, 1, batch_size>> layers;
+	};
+
+
+	// specialization of the neural network for inputs whose number is only known at run time, i.e. rows of a dataset
+	// whose width is read from its file, which are vectors or sparse rows rather than matrices and whose first layer
+	// loops over them, one sample at a time
+	template<typename T>
+	class NeuralNet<T, dynamic_x_vars, 1>
+	{
+	public:
+
+		// constructor which takes a learning rate
+		NeuralNet(T learning_rate) : learning_rate(learning_rate), linear_layer_1(learning_rate), other_layers(learning_rate)
+		{
+			// initialize weights of the second linear layer, as the first initializes its own once it sees its inputs
+			other_layers.template get<1>().kaiming_he_init();
+		}
+
+
+		// constructor which creates a replica of a network, with its own records of the forward and backward passes,
+		// which trains the parameters of the original network without locks; the weights of the original's first
+		// linear layer must have been initialized by a forward pass before the replica is used
+		NeuralNet(NeuralNet& shared_network, SharedParametersTag tag) :
+			learning_rate(shared_network.learning_rate),
+			linear_layer_1(shared_network.linear_layer_1, tag),
+			other_layers(shared_network.other_layers, tag)
+		{
 		}
 
 
 		// call operator which performs the forward pass
-		virtual Matrix<T, 1, 1>* operator()(Matrix<T, 1, input_cols>* x) override
+		Matrix<T, 1, 1>* operator()(const std::vector<T>* x)
+		{
+			layer_1_outputs = linear_layer_1(x);
+			return other_layers(layer_1_outputs);
+		}
+
+
+		// call operator which performs the forward pass for a row of a sparse dataset
+		Matrix<T, 1, 1>* operator()(const SparseRow<T>* x)
 		{
-			return layer_2_sigmoid_activation(linear_layer_2(layer_1_relu_activation(linear_layer_1(x))));
+			layer_1_outputs = linear_layer_1(x);
+			return other_layers(layer_1_outputs);
 		}
 
 
-		// backward pass
-		virtual void backward() override
+		// backward pass, where the outputs of the first linear layer are its gradient-enabled output matrix
+		void backward()
 		{
-			layer_2_sigmoid_activation.backward();
-			linear_layer_2.backward();
-			layer_1_relu_activation.backward();
+			other_layers.backward(static_cast<GradMatrix<T, 1, 8>*>(layer_1_outputs));
 			linear_layer_1.backward();
 		}
 
 
 		// updates the parameters of both linear layers
-		virtual void update() override
+		void update()
 		{
 			linear_layer_1.update();
-			linear_layer_2.update();
+			other_layers.update();
+		}
+
+
+		// getter for learning rate
+		T get_lr()
+		{
+			return learning_rate;
 		}
 
 
 		// sets the learning rate
-		virtual void set_lr(T new_learning_rate) override
+		void set_lr(T new_learning_rate)
 		{
-			this->learning_rate = new_learning_rate;
+			learning_rate = new_learning_rate;
 			linear_layer_1.set_lr(new_learning_rate);
-			linear_layer_2.set_lr(new_learning_rate);
+			other_layers.set_lr(new_learning_rate);
+		}
+
+
+		// exports the network as a self-contained C++ header defining a function template of the given name, with the
+		// weights as constants and the dot products unrolled, which needs the number of inputs to be known from a forward pass
+		void export_header(const std::string& file_name, const std::string& function_name) const
+		{
+			if (linear_layer_1.get_n_inputs() == 0)
+			{
+				throw std::logic_error("NeuralNet: the number of inputs is not known until the network has made a forward pass");
+			}
+			const auto& linear_layer_2 = other_layers.template get<1>();
+			export_network_header<T>(file_name, function_name, static_cast<int>(linear_layer_1.get_n_inputs()), 8, linear_layer_1.get_weights().data(),
+				&linear_layer_1.get_biases()[0][0], &linear_layer_2.get_weights()[0][0], linear_layer_2.get_biases()[0][0]);
 		}
 
 
 	private:
 
-		// first linear layer with 8 units (neurons)
-		Linear<T, input_cols, 8> linear_layer_1;
-		// relu activation function for first linear layer
-		Relu<T, 8> layer_1_relu_activation;
-		// second linear layer with a single unit
-		Linear<T, 8, 1> linear_layer_2;
-		// sigmoid activation function for second linear layer
-		Sigmoid<T, 1> layer_2_sigmoid_activation;
+		// learning rate for the network's parameters
+		T learning_rate = 0;
+
+		// first linear layer with 8 units (neurons), whose number of inputs is set by its first forward pass
+		DynamicLinear<T, 8> linear_layer_1;
+		// outputs of the first linear layer in the last forward pass
+		Matrix<T, 1, 8>* layer_1_outputs = nullptr;
+		// relu activation function for first linear layer, and second linear layer with
+		// a single unit and a sigmoid activation function
+		Sequential<Relu<T, 8>, LinearSigmoid<T, 8, 1>> other_layers;
 	};
 }
\ No newline at end of file
@@ -5,15 +5,19 @@
 #include <sstream>
 #include <fstream>
 #include <iterator>
+#include <algorithm>
+#include <type_traits>
 
 #include "Matrix.h"
+#include "dispatch_x_vars.h"
 
 
 namespace MLComparison
 {
 	// class template for a dataset suitable for a neural network model
 	// i.e each row is composed of a Matrix of independent variables
-	// and a dependent variable which is a plain number
+	// and a dependent variable which is a plain number; if the number of independent variables is dynamic_x_vars,
+	// it is read from the csv file and the independent variables of each row are a vector instead
 	template<typename T, size_t x_variables, size_t x_variables_to_use = x_variables>
 	class NeuralNetDataset
 	{
@@ -32,25 +36,25 @@ namespace MLComparison
 		}
 
 
-		Matrix<T, 1, x_variables>& operator[](int i)
+		auto& operator[](int i)
 		{
 			return data_table[i];
 		}
 
 
-		const Matrix<T, 1, x_variables>& operator[](int i) const
+		const auto& operator[](int i) const
 		{
 			return data_table[i];
 		}
 
 
-		Matrix<T, 1, x_variables>& at(int i)
+		auto& at(int i)
 		{
 			return data_table[i];
 		}
 
 
-		const Matrix<T, 1, x_variables>& at(int i) const
+		const auto& at(int i) const
 		{
 			return data_table[i];
 		}
@@ -101,20 +105,26 @@ namespace MLComparison
 			// for each row
 			for (int row = 0; std::getline(infile, line); row++)
 			{
+				// if the width is dynamic, count the independent variables in the first line and use them all
+				if (is_dynamic && row == 0)
+				{
+					n_x_vars = static_cast<int>(std::count(line.begin(), line.end(), ','));
+					n_x_vars_to_use = n_x_vars;
+				}
 				// construct new row in data table
-				data_table.emplace_back();
+				data_table.emplace_back(make_input(std::integral_constant<bool, is_dynamic>()), T(0));
 				// create stream for line
 				line_stream = std::istringstream(line);
 				// for each independent variable to use
-				for (int col = 0; col < x_variables_to_use; col++)
+				for (int col = 0; col < n_x_vars_to_use; col++)
 				{
 					// get field from row
 					std::getline(line_stream, item, ',');
 					// set corresponding element in x dataset
-					data_table[row].first[0][col] = std::stod(item);
+					element(data_table[row].first, col) = std::stod(item);
 				}
 				// skip past each unused independent variable
-				for (int col = 0; col < x_variables - x_variables_to_use; col++)
+				for (int col = 0; col < n_x_vars - n_x_vars_to_use; col++)
 				{
 					std::getline(line_stream, item, ',');
 				}
@@ -129,9 +139,9 @@ namespace MLComparison
 		{
 			for (auto& row : data_table)
 			{
-				for (auto i : row.first[0])
+				for (int col = 0; col < n_x_vars_to_use; col++)
 				{
-					std::cout << i << " ";
+					std::cout << element(row.first, col) << " ";
 				}
 				std::cout << row.second << std::endl;
 			}
@@ -140,6 +150,45 @@ namespace MLComparison
 
 	private:
 
-		std::vector<std::pair<Matrix<T, 1, x_variables_to_use>, T>> data_table;
+		// whether the number of independent variables is read from the csv file, in which case all of them are used
+		static const bool is_dynamic = x_variables == dynamic_x_vars;
+		static_assert(!is_dynamic || x_variables_to_use == dynamic_x_vars, "a dataset of dynamic width uses all of its independent variables");
+		// alias for the independent variables of a row, a matrix unless their number is dynamic
+		using Input = typename std::conditional<is_dynamic, std::vector<T>, Matrix<T, 1, (is_dynamic ? 1 : x_variables_to_use)>>::type;
+
+
+		// returns new independent variables for a dataset of fixed width
+		Input make_input(std::false_type) const
+		{
+			return Input();
+		}
+
+
+		// returns new independent variables for a dataset whose width is read from its csv file
+		Input make_input(std::true_type) const
+		{
+			return Input(n_x_vars, T(0));
+		}
+
+
+		// returns an element of independent variables stored in a matrix
+		static T& element(Matrix<T, 1, (is_dynamic ? 1 : x_variables_to_use)>& input, int col)
+		{
+			return input[0][col];
+		}
+
+
+		// returns an element of independent variables stored in a vector
+		static T& element(std::vector<T>& input, int col)
+		{
+			return input[col];
+		}
+
+
+		// number of independent variables in the dataset, and the number of them used
+		int n_x_vars = x_variables;
+		int n_x_vars_to_use = x_variables_to_use;
+
+		std::vector<std::pair<Input, T>> data_table;
 	};
 }
\ No newline at end of file
@@ -3,17 +3,30 @@
 #include <chrono>
 #include <string>
 #include <cmath>
+#include <array>
+#include <vector>
+#include <memory>
+#include <iterator>
+#include <type_traits>
 
 #include "NeuralNetDataset.h"
+#include "SparseDataset.h"
 #include "NeuralNet.h"
 #include "MSELoss.h"
 #include "calculate_rows_to_use.h"
+#include "WorkStealingThreadPool.h"
 
 
 namespace MLComparison
 {
-	// class template for a neural network prediction model suitable for binary classification
-	template<typename T, size_t dataset_x_vars, size_t model_x_vars = dataset_x_vars>
+	// class template for a neural network prediction model suitable for binary classification, whose datasets are
+	// NeuralNetDatasets unless another type of dataset, such as a SparseDataset for a model of dynamic_x_vars width, is given;
+	// the network is trained on mini-batches of the given number of samples, with its gradients averaged over each batch
+	// and its parameters updated once per batch, where a final partial batch is padded with rows the loss ignores; with
+	// more than one thread, the network is trained in the manner of Hogwild, with each thread training a replica of the
+	// network which shares its parameters on its own shard of the rows, and updating the parameters without locks
+	template<typename T, size_t dataset_x_vars, size_t model_x_vars = dataset_x_vars, size_t batch_size = 1,
+		typename DatasetType = NeuralNetDataset<T, dataset_x_vars, model_x_vars>>
 	class NeuralNetModel
 	{	
 	public:
@@ -28,7 +41,7 @@ namespace MLComparison
 		NeuralNetModel(const std::string& train_csv, const std::string& valid_csv, T learning_rate) :
 			training_set(train_csv),
 			validation_set(valid_csv),
-			neural_net(learning_rate)
+			context(learning_rate)
 		{
 		}
 
@@ -43,7 +56,34 @@ namespace MLComparison
 		// sets the learning rate
 		void set_learning_rate(T new_learning_rate)
 		{
-			neural_net.set_lr(new_learning_rate);
+			context.neural_net.set_lr(new_learning_rate);
+			for (auto& replica_context_ptr : replica_contexts)
+			{
+				replica_context_ptr->neural_net.set_lr(new_learning_rate);
+			}
+		}
+
+
+		// get the number of threads with which to train
+		int get_n_threads()
+		{
+			return n_threads;
+		}
+
+
+		// set the number of threads with which to train, where the network is trained without locks if more than one,
+		// so that training is no longer deterministic
+		void set_n_threads(int new_n_threads)
+		{
+			n_threads = new_n_threads;
+		}
+
+
+		// exports the trained network as a self-contained C++ header defining a function template of the given name
+		// which returns the network's predicted probability of the positive class for a sample
+		void export_header(const std::string& file_name, const std::string& function_name) const
+		{
+			context.neural_net.export_header(file_name, function_name);
 		}
 
 
@@ -68,26 +108,37 @@ namespace MLComparison
 			// number of rows to use, calculated from the given preset number
 			size_t rows_to_use = calculate_rows_to_use(8, eighths_rows_to_use, training_set.size());
 
+			// get the thread pool and the replicas of the network, if any, before timing, as creating them is not part
+			// of training
+			WorkStealingThreadPool* thread_pool = get_thread_pool(rows_to_use);
+
 			// get start time
 			the_clock::time_point start = the_clock::now();
 
-			// for each epoch
-			for (size_t epoch = 0; epoch < n_epochs; epoch++)
+			if (thread_pool == nullptr)
 			{
-				// for each training sample to use
-				for (auto it = training_set.begin(); it < training_set.end(rows_to_use); ++it)
+				// for each epoch
+				for (size_t epoch = 0; epoch < n_epochs; epoch++)
 				{
-					// get reference to current sample
-					auto& row = *it;
-					// perform forward pass
-					loss(neural_net(&row.first), row.second);
-					// perform backward pass
-					loss.backward();
-					neural_net.backward();
-					// update the parameters
-					neural_net.update();
+					// train on the training samples to use, one or a batch at a time
+					train_epoch(context, training_set.begin(), training_set.end(rows_to_use), std::integral_constant<bool, batch_size == 1>());
 				}
 			}
+			else
+			{
+				// each thread trains its own context for every epoch on its shard of the training samples to use,
+				// without waiting for the other threads between epochs
+				auto first = training_set.begin();
+				parallel_for(thread_pool, n_threads, [this, first, rows_to_use, n_epochs](int thread) {
+					TrainingContext& thread_context = thread == 0 ? context : *replica_contexts[thread - 1];
+					auto shard_first = std::next(first, rows_to_use * thread / n_threads);
+					auto shard_last = std::next(first, rows_to_use * (thread + 1) / n_threads);
+					for (size_t epoch = 0; epoch < n_epochs; epoch++)
+					{
+						train_epoch(thread_context, shard_first, shard_last, std::integral_constant<bool, batch_size == 1>());
+					}
+				});
+			}
 
 			// get end time
 			the_clock::time_point end = the_clock::now();
@@ -109,14 +160,8 @@ namespace MLComparison
 			// get end iterator
 			auto end_iterator = validation_set.begin();
 			std::advance(end_iterator, rows_to_use);
-			// for each sample in the validation set
-			for (auto it = validation_set.begin(); it < end_iterator; ++it)
-			{
-				// get sample
-				auto& row = *it;
-				// calculate the model's prediction
-				neural_net(&row.first);
-			}
+			// calculate the model's predictions for the samples in the validation set to use
+			evaluate(context, validation_set.begin(), end_iterator, nullptr, nullptr, std::integral_constant<bool, batch_size == 1>());
 
 			// get end time
 			the_clock::time_point end = the_clock::now();
@@ -126,18 +171,8 @@ namespace MLComparison
 			// total correct predictions
 			T total_correct = 0;
 
-			// for each sample in the validation set
-			for (auto& row : validation_set)
-			{
-				// calculate the model's prediction
-				auto prediction = neural_net(&row.first);
-				// get the target value
-				auto target = row.second;
-				// calculate the MSE of the model's prediction
-				total_loss += loss(prediction, target);
-				// add whether the prediction was correct to the total of correct predictions
-				total_correct += (std::round(prediction->at(0)[0]) == std::round(target));
-			}
+			// add up the loss and correct predictions over all the samples in the validation set
+			evaluate(context, validation_set.begin(), validation_set.end(), &total_loss, &total_correct, std::integral_constant<bool, batch_size == 1>());
 
 			// calculate and save the average loss and the accuracy
 			validation_loss = total_loss / validation_set.size();
@@ -150,19 +185,199 @@ namespace MLComparison
 
 	private:
 
+		// struct for the objects with which a thread trains the network, i.e. the network itself, the loss function and
+		// the inputs and targets of the current mini-batch of samples, if they are taken in batches
+		struct TrainingContext
+		{
+			// constructor which takes the network's learning rate
+			TrainingContext(T learning_rate) : neural_net(learning_rate)
+			{
+			}
+
+
+			// constructor which creates a context for another thread, whose network is a replica of the given
+			// context's network which shares its parameters
+			TrainingContext(TrainingContext& shared_context, SharedParametersTag tag) : neural_net(shared_context.neural_net, tag)
+			{
+			}
+
+
+			// neural network itself
+			NeuralNet<T, model_x_vars, batch_size> neural_net;
+
+			// mean squared error loss function object
+			MSELoss<T, batch_size> loss;
+
+			// inputs and targets of the current mini-batch of samples, if they are taken in batches
+			Matrix<T, batch_size, (batch_size == 1 ? 1 : model_x_vars)> batch_inputs;
+			std::array<T, batch_size> batch_targets = {};
+		};
+
+
+		// method template for training the network of a context for one epoch on a range of rows, one sample at a time
+		template<typename RowIterator>
+		static void train_epoch(TrainingContext& context, RowIterator first, RowIterator last, std::true_type)
+		{
+			// for each training sample to use
+			for (auto it = first; it < last; ++it)
+			{
+				// get reference to current sample
+				auto& row = *it;
+				// perform forward pass
+				context.loss(context.neural_net(&row.first), row.second);
+				// perform backward pass
+				context.loss.backward();
+				context.neural_net.backward();
+				// update the parameters
+				context.neural_net.update();
+			}
+		}
+
+
+		// method template for training the network of a context for one epoch on a range of rows, a mini-batch at a time
+		template<typename RowIterator>
+		static void train_epoch(TrainingContext& context, RowIterator first, RowIterator last, std::false_type)
+		{
+			// for each batch of training samples to use
+			for (auto it = first; it < last;)
+			{
+				// copy the batch's samples into the batch matrix
+				int n_samples = fill_batch(context, it, last);
+				// perform forward pass
+				context.loss(context.neural_net(&context.batch_inputs), context.batch_targets, n_samples);
+				// perform backward pass
+				context.loss.backward();
+				context.neural_net.backward();
+				// update the parameters
+				context.neural_net.update();
+			}
+		}
+
+
+		// method template for calculating the predictions of the network of a context for a range of rows one sample
+		// at a time, adding the loss and whether each prediction is correct to the given totals unless they are null
+		template<typename RowIterator>
+		static void evaluate(TrainingContext& context, RowIterator first, RowIterator last, T* total_loss, T* total_correct, std::true_type)
+		{
+			// for each sample
+			for (auto it = first; it < last; ++it)
+			{
+				// get sample
+				auto& row = *it;
+				// calculate the model's prediction
+				auto prediction = context.neural_net(&row.first);
+				if (total_loss != nullptr)
+				{
+					// calculate the MSE of the model's prediction
+					*total_loss += context.loss(prediction, row.second);
+					// add whether the prediction was correct to the total of correct predictions
+					*total_correct += (std::round(prediction->at(0)[0]) == std::round(row.second));
+				}
+			}
+		}
+
+
+		// method template for calculating the predictions of the network of a context for a range of rows a mini-batch
+		// at a time, adding the loss and whether each prediction is correct to the given totals unless they are null
+		template<typename RowIterator>
+		static void evaluate(TrainingContext& context, RowIterator first, RowIterator last, T* total_loss, T* total_correct, std::false_type)
+		{
+			// for each batch of samples
+			for (auto it = first; it < last;)
+			{
+				// copy the batch's samples into the batch matrix and calculate the model's predictions
+				int n_samples = fill_batch(context, it, last);
+				auto predictions = context.neural_net(&context.batch_inputs);
+				if (total_loss != nullptr)
+				{
+					// calculate the MSE of the model's predictions, which the loss averages over the batch
+					*total_loss += context.loss(predictions, context.batch_targets, n_samples) * n_samples;
+					// add whether each prediction was correct to the total of correct predictions
+					for (int row = 0; row < n_samples; row++)
+					{
+						*total_correct += (std::round(predictions->at(row)[0]) == std::round(context.batch_targets[row]));
+					}
+				}
+			}
+		}
+
+
+		// method template for copying the inputs and targets of up to a batch of rows, starting from the given
+		// iterator, which is advanced past them, into the batch matrix of a context, and returning their number; any
+		// remaining rows of the batch matrix are padding, left as they are, which the loss ignores
+		template<typename RowIterator>
+		static int fill_batch(TrainingContext& context, RowIterator& it, RowIterator last)
+		{
+			int n_samples = 0;
+			for (; it < last && n_samples < static_cast<int>(batch_size); ++it, n_samples++)
+			{
+				context.batch_inputs[n_samples] = it->first[0];
+				context.batch_targets[n_samples] = it->second;
+			}
+			return n_samples;
+		}
+
+
+		// returns a pointer to the thread pool used for training, which is created on first use, or null to train on
+		// the calling thread; the calling thread works alongside the pool's workers, so the pool has one fewer worker
+		// than there are threads, each of which is given a context whose network is a replica of the model's network;
+		// the replicas point to the parameters of the model's network, so they are created again for every training
+		// run rather than kept, as those of a model which has since been moved would point to the moved-from model;
+		// a network of dynamic width initializes its parameters on its first forward pass, so that pass is made on
+		// the first of the rows to use before the replicas share them
+		WorkStealingThreadPool* get_thread_pool(size_t rows_to_use)
+		{
+			if (n_threads <= 1 || rows_to_use == 0)
+			{
+				return nullptr;
+			}
+			if (thread_pool_ptr == nullptr || thread_pool_ptr->size() != static_cast<size_t>(n_threads - 1))
+			{
+				thread_pool_ptr.reset(new WorkStealingThreadPool(n_threads - 1));
+			}
+			initialize_parameters(training_set.begin(), std::integral_constant<bool, model_x_vars == dynamic_x_vars>());
+			replica_contexts.clear();
+			while (replica_contexts.size() < static_cast<size_t>(n_threads - 1))
+			{
+				replica_contexts.emplace_back(new TrainingContext(context, SharedParametersTag()));
+			}
+			return thread_pool_ptr.get();
+		}
+
+
+		// method template which initializes the parameters of a network of dynamic width with a forward pass on a row
+		template<typename RowIterator>
+		void initialize_parameters(RowIterator first, std::true_type)
+		{
+			context.neural_net(&first->first);
+		}
+
+
+		// overload for a network of fixed width, whose parameters are initialized when it is created
+		template<typename RowIterator>
+		void initialize_parameters(RowIterator, std::false_type)
+		{
+		}
+
+
 		// validation loss and accuracy
 		T validation_loss = 0;
 		T validation_accuracy = 0;
 
 		// training and validation sets
-		NeuralNetDataset<T, dataset_x_vars, model_x_vars> training_set;
-		NeuralNetDataset<T, dataset_x_vars, model_x_vars> validation_set;
-		
-		// neural network itself
-		NeuralNet<T, model_x_vars> neural_net;
+		DatasetType training_set;
+		DatasetType validation_set;
 		
-		// mean squared error loss function object
-		MSELoss<T> loss;
+		// context with which the network is trained and evaluated on the calling thread
+		TrainingContext context;
+
+		// number of threads with which to train
+		int n_threads = 1;
+		// thread pool used for training with more than one thread
+		std::unique_ptr<WorkStealingThreadPool> thread_pool_ptr = nullptr;
+		// contexts of the pool's workers, whose networks are replicas of the network which share its parameters,
+		// created for each training run with more than one thread
+		std::vector<std::unique_ptr<TrainingContext>> replica_contexts = {};
 
 		// alias for chrono::steady_clock used for performance measurement
 		using the_clock = std::chrono::steady_clock;
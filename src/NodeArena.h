@@ -0,0 +1,109 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <type_traits>
+#include <algorithm>
+
+
+namespace MLComparison
+{
+	// class template for an arena which owns all the nodes of a tree, constructing them in blocks of storage
+	// which grow geometrically, so that building a tree makes a handful of allocations and destroying it frees
+	// those blocks without visiting each node when the node type is trivially destructible
+	template<typename NodeType>
+	class NodeArena
+	{
+	public:
+
+		// default constructor which allocates nothing until the first node is created
+		NodeArena()
+		{
+		}
+
+
+		// destructor which destroys all the nodes
+		~NodeArena()
+		{
+			clear();
+		}
+
+
+		// the arena owns its nodes, which refer to each other by address, so it is neither copyable nor assignable
+		NodeArena(const NodeArena&) = delete;
+		NodeArena& operator=(const NodeArena&) = delete;
+
+
+		// constructs a node from the given arguments and returns a pointer to it, which remains valid until the arena
+		// is cleared or destroyed; nodes may be created by several threads at once
+		template<typename... Args>
+		NodeType* create(Args&&... args)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			// start a new block, twice the size of the last, if the current one is full
+			if (blocks.empty() || n_used == block_sizes.back())
+			{
+				size_t block_size = blocks.empty() ? first_block_size : block_sizes.back() * 2;
+				blocks.emplace_back(new Storage[block_size]);
+				block_sizes.push_back(block_size);
+				n_used = 0;
+			}
+			// construct the node in the next free slot, which is only counted as used once construction succeeds
+			NodeType* node = new (&blocks.back()[n_used]) NodeType(std::forward<Args>(args)...);
+			n_used++;
+			n_nodes++;
+			return node;
+		}
+
+
+		// destroys all the nodes and frees the storage they occupied
+		void clear()
+		{
+			// nodes need only be visited if they have destructors to run
+			if (!std::is_trivially_destructible<NodeType>::value)
+			{
+				for (size_t block = 0; block < blocks.size(); block++)
+				{
+					size_t n_constructed = block + 1 < blocks.size() ? block_sizes[block] : n_used;
+					for (size_t i = 0; i < n_constructed; i++)
+					{
+						reinterpret_cast<NodeType*>(&blocks[block][i])->~NodeType();
+					}
+				}
+			}
+			blocks.clear();
+			block_sizes.clear();
+			n_used = 0;
+			n_nodes = 0;
+		}
+
+
+		// returns the number of nodes in the arena
+		size_t size() const
+		{
+			return n_nodes;
+		}
+
+
+	private:
+
+		// alias for uninitialised storage for one node
+		using Storage = typename std::aligned_storage<sizeof(NodeType), alignof(NodeType)>::type;
+
+		// number of nodes which fit in the first block
+		static const size_t first_block_size = 64;
+
+		// blocks of storage and the number of nodes which fit in each
+		std::vector<std::unique_ptr<Storage[]>> blocks = {};
+		std::vector<size_t> block_sizes = {};
+		// number of slots of the last block in which nodes have been constructed
+		size_t n_used = 0;
+		// total number of nodes in the arena
+		size_t n_nodes = 0;
+
+		// mutex which guards the creation of nodes
+		std::mutex mutex;
+	};
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <algorithm>
+
+#include "dispatch_x_vars.h"
+
+
+namespace MLComparison
+{
+	// class template for scoring an ensemble of trained binary classification decision trees by the QuickScorer
+	// method, where each tree has at most 64 leaves, numbered from left to right, and the leaves a sample can still
+	// reach are tracked as a 64-bit mask per tree; every split is stored as a condition on its variable with a mask
+	// which clears the leaves of its left subtree, and the conditions of each variable are sorted by threshold, so
+	// that a sample is scored by finding the first threshold above its value of each variable and ANDing the masks
+	// of the conditions before it into their trees' masks, after which each tree's exit leaf is the lowest bit left
+	// set; the scan reads the conditions in order rather than following pointers, and the only branches it takes
+	// are the bounds of its loops rather than the outcomes of the splits; for samples of dynamic_x_vars width, the
+	// variables scanned are those up to the highest variable any tree splits on
+	template<typename T, size_t dataset_x_vars>
+	class QuickScorer
+	{
+	public:
+
+		// default constructor which leaves the ensemble empty
+		QuickScorer()
+		{
+		}
+
+
+		// constructor which compiles the trees with the given root nodes
+		template<typename NodeType>
+		explicit QuickScorer(const std::vector<const NodeType*>& roots)
+		{
+			compile(roots);
+		}
+
+
+		// compiles the trees with the given root nodes, which must be trained and have at most 64 leaves each
+		template<typename NodeType>
+		void compile(const std::vector<const NodeType*>& roots)
+		{
+			// list the conditions of every tree and the mask of leaves which predict the positive class
+			std::vector<Condition> conditions;
+			positive_leaves.assign(roots.size(), 0);
+			for (size_t tree = 0; tree < roots.size(); tree++)
+			{
+				int n_leaves = 0;
+				add_conditions(*roots[tree], static_cast<uint32_t>(tree), conditions, n_leaves);
+			}
+
+			// sort the conditions by variable, then by threshold, and store their fields in separate arrays
+			std::sort(conditions.begin(), conditions.end(), [](const Condition& a, const Condition& b) {
+				return a.split_var != b.split_var ? a.split_var < b.split_var : a.threshold < b.threshold;
+			});
+			thresholds.resize(conditions.size());
+			tree_indices.resize(conditions.size());
+			masks.resize(conditions.size());
+			n_vars = dataset_x_vars;
+			for (size_t i = 0; i < conditions.size() && is_dynamic; i++)
+			{
+				n_vars = std::max(n_vars, static_cast<size_t>(conditions[i].split_var) + 1);
+			}
+			var_offsets.assign(n_vars + 1, 0);
+			for (size_t i = 0; i < conditions.size(); i++)
+			{
+				thresholds[i] = conditions[i].threshold;
+				tree_indices[i] = conditions[i].tree;
+				masks[i] = conditions[i].mask;
+				var_offsets[conditions[i].split_var + 1]++;
+			}
+			std::partial_sum(var_offsets.begin(), var_offsets.end(), var_offsets.begin());
+		}
+
+
+		// returns the number of trees in the ensemble
+		size_t get_n_trees() const
+		{
+			return positive_leaves.size();
+		}
+
+
+		// method template for counting the trees which predict the positive class for a sample
+		template<typename SampleType>
+		int score(const SampleType& sample) const
+		{
+			std::vector<uint64_t> leaf_masks(positive_leaves.size());
+			return score(sample, leaf_masks);
+		}
+
+
+		// method template for making a prediction based on a sample, which is the class predicted by most trees
+		template<typename SampleType>
+		int predict(const SampleType& sample) const
+		{
+			return 2 * score(sample) > static_cast<int>(positive_leaves.size()) ? 1 : 0;
+		}
+
+
+		// method template for making predictions for a range of samples, writing them to the given output iterator
+		template<typename RowIterator, typename OutputIterator>
+		void predict_batch(RowIterator first, RowIterator last, OutputIterator predictions) const
+		{
+			// masks of the leaves each tree can reach, reused for each sample
+			std::vector<uint64_t> leaf_masks(positive_leaves.size());
+			for (; first != last; ++first)
+			{
+				*predictions++ = 2 * score(*first, leaf_masks) > static_cast<int>(positive_leaves.size()) ? 1 : 0;
+			}
+		}
+
+
+	private:
+
+		// struct for the condition of a split, which clears the leaves of its left subtree from its tree's mask
+		// when the sample's value of the split variable is not below the threshold
+		struct Condition
+		{
+			T threshold;
+			uint64_t mask;
+			uint32_t tree;
+			int split_var;
+		};
+
+
+		// method template for adding the conditions of the subtree with the given root node, whose leftmost leaf
+		// is numbered n_leaves, which is advanced past the subtree's leaves
+		template<typename NodeType>
+		void add_conditions(const NodeType& node, uint32_t tree, std::vector<Condition>& conditions, int& n_leaves)
+		{
+			// leaves are numbered from left to right, and only the positive ones are recorded
+			if (node.is_leaf())
+			{
+				if (n_leaves >= max_leaves)
+				{
+					throw std::length_error("QuickScorer: a tree has more than 64 leaves");
+				}
+				if (node.get_class_prediction() == 1)
+				{
+					positive_leaves[tree] |= uint64_t(1) << n_leaves;
+				}
+				n_leaves++;
+				return;
+			}
+			if (node.get_split_var() < 0 || (!is_dynamic && static_cast<size_t>(node.get_split_var()) >= dataset_x_vars))
+			{
+				throw std::out_of_range("QuickScorer: split variable is not a variable of the samples");
+			}
+
+			// the node's mask clears the leaves of its left subtree
+			int first_left_leaf = n_leaves;
+			add_conditions(*node.get_left(), tree, conditions, n_leaves);
+			uint64_t left_leaves = (n_leaves - first_left_leaf == max_leaves ? ~uint64_t(0) : (uint64_t(1) << (n_leaves - first_left_leaf)) - 1) << first_left_leaf;
+			conditions.push_back({ static_cast<T>(node.get_split_val()), ~left_leaves, tree, node.get_split_var() });
+			add_conditions(*node.get_right(), tree, conditions, n_leaves);
+		}
+
+
+		// method template for counting the trees which predict the positive class for a sample, given space for the
+		// mask of each tree
+		template<typename SampleType>
+		int score(const SampleType& sample, std::vector<uint64_t>& leaf_masks) const
+		{
+			// every leaf can be reached before any condition is applied
+			std::fill(leaf_masks.begin(), leaf_masks.end(), ~uint64_t(0));
+
+			// apply the masks of the conditions of each variable which the sample's value does not satisfy,
+			// i.e. those whose thresholds are not above it, which are found by binary search; the number of variables
+			// is a constant unless the samples are of dynamic width
+			size_t n_scanned_vars = is_dynamic ? n_vars : dataset_x_vars;
+			for (size_t var = 0; var < n_scanned_vars; var++)
+			{
+				auto var_end = std::upper_bound(thresholds.begin() + var_offsets[var], thresholds.begin() + var_offsets[var + 1], static_cast<T>(sample[var]));
+				uint32_t n_applied = static_cast<uint32_t>(var_end - thresholds.begin());
+				for (uint32_t i = var_offsets[var]; i < n_applied; i++)
+				{
+					leaf_masks[tree_indices[i]] &= masks[i];
+				}
+			}
+
+			// each tree's exit leaf is the lowest bit left set, which votes if it predicts the positive class
+			int votes = 0;
+			for (size_t tree = 0; tree < leaf_masks.size(); tree++)
+			{
+				uint64_t exit_leaf = leaf_masks[tree] & (~leaf_masks[tree] + 1);
+				votes += (exit_leaf & positive_leaves[tree]) != 0;
+			}
+			return votes;
+		}
+
+
+		// maximum number of leaves of a tree, one per bit of its mask
+		static const int max_leaves = 64;
+		// whether the number of variables of the samples is dynamic
+		static const bool is_dynamic = dataset_x_vars == dynamic_x_vars;
+
+		// fields of the conditions, sorted by variable, then by threshold
+		std::vector<T> thresholds = {};
+		std::vector<uint32_t> tree_indices = {};
+		std::vector<uint64_t> masks = {};
+		// number of variables whose conditions are scanned
+		size_t n_vars = dataset_x_vars;
+		// index of the first condition of each variable, followed by the number of conditions
+		std::vector<uint32_t> var_offsets = std::vector<uint32_t>(dataset_x_vars + 1, 0);
+
+		// mask of the leaves of each tree which predict the positive class
+		std::vector<uint64_t> positive_leaves = {};
+	};
+}
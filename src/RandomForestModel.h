@@ -0,0 +1,360 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include <array>
+#include <random>
+#include <iterator>
+#include <algorithm>
+
+#include "DecisionTreeDataset.h"
+#include "DecisionTreeNode.h"
+#include "DecisionTreeSettings.h"
+#include "DecisionTreeWorkspace.h"
+#include "FlatDecisionTree.h"
+#include "WorkStealingThreadPool.h"
+#include "calculate_rows_to_use.h"
+
+
+namespace MLComparison
+{
+	// class template for a random forest prediction model suitable for binary classification, i.e. an ensemble
+	// of decision trees which are each trained on a bootstrap sample of the training set, considering a random
+	// subset of the variables at each node, and which predicts the class most of its trees predict
+	template<typename T, size_t dataset_x_vars>
+	class RandomForestModel
+	{
+	public:
+
+		// default constructor
+		RandomForestModel()
+		{
+		}
+
+
+		// constructor which takes the names of csv files for the training and validation sets and the number of trees
+		RandomForestModel(const std::string& train_csv, const std::string& valid_csv, int number_of_trees = 100) :
+			n_trees(number_of_trees), validation_set(valid_csv)
+		{
+			// construct a new training dataset, which all the trees share
+			training_set_ptr.reset(new DecisionTreeDataset<T, dataset_x_vars>);
+			// load training data
+			training_set_ptr->load_data(train_csv);
+		}
+
+
+		// get accuracy
+		T get_accuracy()
+		{
+			return validation_accuracy;
+		}
+
+
+		// get the number of trees
+		int get_n_trees()
+		{
+			return n_trees;
+		}
+
+
+		// set the number of trees, which applies from the next call to train, until which predictions are made by the
+		// trees already trained
+		void set_n_trees(int new_n_trees)
+		{
+			n_trees = new_n_trees;
+		}
+
+
+		// get training settings
+		const DecisionTreeSettings& get_settings()
+		{
+			return settings;
+		}
+
+
+		// set training settings, which apply from the next call to train; max_features of 0 means the
+		// rounded square root of the number of variables used, and n_threads also sets how many trees train at once
+		void set_settings(const DecisionTreeSettings& new_settings)
+		{
+			settings = new_settings;
+		}
+
+
+		// loads a csv file as the training set
+		void load_training_set_file(const std::string& csv_file)
+		{
+			training_set_ptr->load_data(csv_file);
+		}
+
+
+		// loads a csv file as the validation set
+		void load_validation_set_file(const std::string& csv_file)
+		{
+			validation_set.load_data(csv_file);
+		}
+
+
+		// trains the model using a certain proportion of the training samples
+		// and a given number of fields within these samples
+		long long train(uint8_t eighths_rows_to_use, size_t x_vars_to_use)
+		{
+			// number of rows to use
+			size_t rows_to_use = calculate_rows_to_use(8, eighths_rows_to_use, training_set_ptr->size());
+			// number of fields to use, which cannot exceed the number in the training set, whose width may be read from its file
+			x_vars_to_use = std::min(x_vars_to_use, static_cast<size_t>(training_set_ptr->get_n_x_vars()));
+
+			// quantize the training set once if class histograms are used, before the trees start
+			// training, so that the dataset is not modified while they share it
+			if (uses_histograms(settings) && !training_set_ptr->is_quantized())
+			{
+				training_set_ptr->quantize();
+			}
+
+			// get the thread pool, if any, before timing, as starting its threads is not part of training
+			WorkStealingThreadPool* thread_pool = get_thread_pool();
+
+			// get start time
+			the_clock::time_point start = the_clock::now();
+
+			// train each tree as a task on the thread pool
+			trees.clear();
+			trees.resize(n_trees);
+			parallel_for(thread_pool, n_trees, [this, rows_to_use, x_vars_to_use, thread_pool](int tree) {
+				train_tree(trees[tree], tree, rows_to_use, static_cast<int>(x_vars_to_use), thread_pool);
+			});
+
+			// get end time
+			the_clock::time_point end = the_clock::now();
+
+			// return number of nanoseconds taken
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+		}
+
+
+		// method template for making a prediction based on a sample, which is the class predicted by most trees
+		template<typename SampleType>
+		int predict(const SampleType& sample) const
+		{
+			int votes = 0;
+			for (const auto& tree : trees)
+			{
+				votes += tree.flat_tree.predict(sample);
+			}
+			return 2 * votes > static_cast<int>(trees.size()) ? 1 : 0;
+		}
+
+
+		// method template for making predictions for a range of samples, writing them to the given output iterator;
+		// samples are taken in blocks which every tree scores in turn, so that a block stays in cache while each tree
+		// walks it and the votes for the block are accumulated in a small array rather than across the whole range
+		template<typename RowIterator, typename OutputIterator>
+		void predict_batch(RowIterator first, RowIterator last, OutputIterator predictions) const
+		{
+			// votes for the positive class and one tree's predictions for the current block
+			std::array<int, block_size> votes;
+			std::array<int, block_size> tree_predictions;
+
+			// for each block of samples
+			while (first != last)
+			{
+				// get the end of the block
+				RowIterator block_end = first;
+				int n_samples = 0;
+				for (; block_end != last && n_samples < block_size; ++block_end, n_samples++)
+				{
+				}
+
+				// add the predictions of each tree to the votes
+				votes.fill(0);
+				for (const auto& tree : trees)
+				{
+					tree.flat_tree.predict_batch(first, block_end, tree_predictions.begin());
+					for (int i = 0; i < n_samples; i++)
+					{
+						votes[i] += tree_predictions[i];
+					}
+				}
+
+				// output the class predicted by most trees
+				for (int i = 0; i < n_samples; i++)
+				{
+					*predictions++ = 2 * votes[i] > static_cast<int>(trees.size()) ? 1 : 0;
+				}
+				first = block_end;
+			}
+		}
+
+
+		// determine the model's accuracy using the validation set
+		long long validate(uint8_t eighths_rows_to_use)
+		{
+			// number of rows to use
+			size_t rows_to_use = calculate_rows_to_use(8, eighths_rows_to_use, validation_set.size());
+
+			// total correct predictions
+			T total_correct = 0;
+			// column of the validation set holding the dependent variable, which follows the independent variables
+			size_t y_col = validation_set.get_n_x_vars();
+			// model's predictions for the validation set
+			std::vector<int> predictions(validation_set.size());
+
+			// get start time
+			the_clock::time_point start = the_clock::now();
+
+			// get end iterator
+			auto end_iterator = validation_set.begin();
+			std::advance(end_iterator, rows_to_use);
+			// get model's predictions for the samples in the validation set
+			predict_batch(validation_set.begin(), end_iterator, predictions.begin());
+			// for each sample in the validation set
+			for (size_t i = 0; i < rows_to_use; i++)
+			{
+				// add whether prediction is correct to total correct predictions
+				total_correct += (predictions[i] == validation_set[i][y_col]);
+			}
+
+			// get end time
+			the_clock::time_point end = the_clock::now();
+
+			// total correct predictions
+			total_correct = 0;
+
+			// get model's predictions for all the samples in the validation set
+			predict_batch(validation_set.begin(), validation_set.end(), predictions.begin());
+			// for each sample in the validation set
+			for (size_t i = 0; i < validation_set.size(); i++)
+			{
+				// add whether prediction is correct to total correct predictions
+				total_correct += (predictions[i] == validation_set[i][y_col]);
+			}
+
+			// calculate and record validation accuracy
+			validation_accuracy = total_correct / validation_set.size();
+
+			// return number of nanoseconds taken
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+		}
+
+
+		// returns the compiled trees of the forest
+		std::vector<const FlatDecisionTree*> get_flat_trees() const
+		{
+			std::vector<const FlatDecisionTree*> flat_trees;
+			for (const auto& tree : trees)
+			{
+				flat_trees.push_back(&tree.flat_tree);
+			}
+			return flat_trees;
+		}
+
+
+		// returns the root nodes of the trained trees of the forest
+		std::vector<const DecisionTreeNode<T, dataset_x_vars>*> get_root_nodes() const
+		{
+			std::vector<const DecisionTreeNode<T, dataset_x_vars>*> root_nodes;
+			for (const auto& tree : trees)
+			{
+				root_nodes.push_back(tree.root_node_ptr);
+			}
+			return root_nodes;
+		}
+
+
+	private:
+
+		// struct for one tree of the forest, which owns the row indices its nodes partition
+		struct Tree
+		{
+			// the tree's bootstrap sample of the training set's row indices
+			std::vector<int> row_indices;
+			// context of the tree, which owns its nodes, and its root node
+			std::unique_ptr<DecisionTreeContext<T, dataset_x_vars>> context_ptr;
+			DecisionTreeNode<T, dataset_x_vars>* root_node_ptr = nullptr;
+			// the trained tree compiled for prediction
+			FlatDecisionTree flat_tree;
+		};
+
+
+		// trains one tree of the forest on a bootstrap sample of the first rows_to_use rows of the training set
+		void train_tree(Tree& tree, int tree_index, size_t rows_to_use, int x_vars_to_use, WorkStealingThreadPool* thread_pool)
+		{
+			// each tree draws its sample and its nodes' variables with its own seed
+			DecisionTreeSettings tree_settings = settings;
+			tree_settings.seed = mix_seed(settings.seed, tree_index);
+			if (tree_settings.max_features <= 0)
+			{
+				tree_settings.max_features = std::max(1, static_cast<int>(std::round(std::sqrt(x_vars_to_use))));
+			}
+
+			// draw the bootstrap sample of row indices, with replacement
+			std::mt19937_64 rng(tree_settings.seed);
+			std::uniform_int_distribution<size_t> dist(0, rows_to_use - 1);
+			auto training_set_begin = training_set_ptr->indices_begin();
+			tree.row_indices.resize(rows_to_use);
+			for (auto& row_index : tree.row_indices)
+			{
+				row_index = training_set_begin[dist(rng)];
+			}
+
+			// sort the sample by each variable once if the sorted sweep split method is used
+			std::shared_ptr<DecisionTreeWorkspace<T, dataset_x_vars>> workspace_ptr = nullptr;
+			if (uses_sorted_indices(tree_settings))
+			{
+				workspace_ptr.reset(new DecisionTreeWorkspace<T, dataset_x_vars>(training_set_ptr, tree.row_indices.begin(), tree.row_indices.end(), x_vars_to_use));
+			}
+
+			// create, train and compile the tree
+			tree.context_ptr.reset(new DecisionTreeContext<T, dataset_x_vars>(*training_set_ptr, x_vars_to_use, tree_settings, workspace_ptr.get(), thread_pool));
+			tree.root_node_ptr = tree.context_ptr->create_root(tree.row_indices.begin(), tree.row_indices.end());
+			tree.root_node_ptr->train();
+			// the workspace is freed once training ends
+			tree.context_ptr->workspace = nullptr;
+			tree.flat_tree.compile(*tree.root_node_ptr);
+		}
+
+
+		// returns a pointer to the thread pool used for training, which is created on first use, or null to train serially
+		WorkStealingThreadPool* get_thread_pool()
+		{
+			if (settings.n_threads <= 1)
+			{
+				return nullptr;
+			}
+			if (thread_pool_ptr == nullptr || thread_pool_ptr->size() != static_cast<size_t>(settings.n_threads - 1))
+			{
+				thread_pool_ptr.reset(new WorkStealingThreadPool(settings.n_threads - 1));
+			}
+			return thread_pool_ptr.get();
+		}
+
+
+		// number of samples scored by every tree in turn by predict_batch
+		static const int block_size = 256;
+
+		// accuracy of the model on the validation set
+		T validation_accuracy = 0;
+
+		// settings which control how each tree is trained
+		DecisionTreeSettings settings;
+
+		// number of trees in the forest
+		int n_trees = 100;
+
+		// shared pointer to the training set, which is shared by all the trees and not modified by them
+		std::shared_ptr<DecisionTreeDataset<T, dataset_x_vars>> training_set_ptr = nullptr;
+		// validation set
+		DecisionTreeDataset<T, dataset_x_vars> validation_set;
+
+		// trees of the forest
+		std::vector<Tree> trees;
+
+		// thread pool used for training with more than one thread
+		std::unique_ptr<WorkStealingThreadPool> thread_pool_ptr = nullptr;
+
+		// alias for chrono::steady_clock used for performance measurement
+		using the_clock = std::chrono::steady_clock;
+	};
+}
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+
+#include "DecisionTreeDataset.h"
+#include "DecisionTreeSettings.h"
+#include "WorkStealingThreadPool.h"
+
+
+namespace MLComparison
+{
+	// struct for the sums of the gradients and hessians of a loss over a group of rows
+	struct GradientPair
+	{
+		double gradient;
+		double hessian;
+	};
+
+
+	// class template for a regression tree fitted to the gradients and hessians of a loss, as trained by a
+	// gradient boosting model, whose split search scans histograms of gradient sums over the quantile bins
+	// of a quantized dataset and whose nodes are stored in a vector with each node's children next to each other
+	template<typename T, int dataset_x_vars>
+	class RegressionTree
+	{
+	public:
+
+		// struct for a node of the tree
+		struct Node
+		{
+			// split value, compared against the sample's value of the split variable
+			T split_val;
+			// value added to the raw score of each sample which reaches the node if it is a leaf
+			double value;
+			// index of the left child node, whose sibling is the right child node at the next index,
+			// or 0 if the node is a leaf
+			int left;
+			// split variable if the node is not a leaf
+			uint16_t split_var;
+			// bin of the split variable whose lower bound is the split value, for samples which are quantized
+			uint8_t split_bin;
+		};
+
+
+		// default constructor
+		RegressionTree()
+		{
+		}
+
+
+		// trains the tree on a group of row indices of a quantized dataset, given the gradient and hessian of the loss
+		// for each row of the dataset and the variables to consider splitting on; the row indices are partitioned
+		// between the leaves, and the value of each leaf is added to the given raw score of each row of its group;
+		// throws std::length_error if a variable to consider is beyond the range of a node's split variable
+		void train(DecisionTreeDataset<T, dataset_x_vars>& training_dataset, const double* row_gradients, const double* row_hessians,
+			std::vector<int>::iterator group_begin, std::vector<int>::iterator group_end, const std::vector<int>& variables,
+			const GradientBoostingSettings& training_settings, double* row_scores, WorkStealingThreadPool* training_thread_pool = nullptr)
+		{
+			for (int var : variables)
+			{
+				if (var > std::numeric_limits<uint16_t>::max())
+				{
+					throw std::length_error("RegressionTree: a variable to consider is beyond the range of a split variable");
+				}
+			}
+
+			dataset = &training_dataset;
+			gradients = row_gradients;
+			hessians = row_hessians;
+			split_vars = variables;
+			settings = training_settings;
+			scores = row_scores;
+			thread_pool = training_thread_pool;
+
+			// grow the tree from the root node
+			nodes.assign(1, {});
+			grow(0, group_begin, group_end, build_histogram(group_begin, group_end), 0);
+
+			// the training state is not kept once the tree is trained
+			dataset = nullptr;
+			gradients = nullptr;
+			hessians = nullptr;
+			scores = nullptr;
+			thread_pool = nullptr;
+		}
+
+
+		// method template for computing the value the tree adds to the raw score of a sample
+		template<typename SampleType>
+		double predict(const SampleType& sample) const
+		{
+			int i = 0;
+			while (nodes[i].left != 0)
+			{
+				const Node& node = nodes[i];
+				i = node.left + !(sample[node.split_var] < node.split_val);
+			}
+			return nodes[i].value;
+		}
+
+
+		// computes the value the tree adds to the raw score of a row of a quantized dataset from its bin codes
+		double predict_binned(const DecisionTreeDataset<T, dataset_x_vars>& quantized_dataset, int row) const
+		{
+			int i = 0;
+			while (nodes[i].left != 0)
+			{
+				const Node& node = nodes[i];
+				i = node.left + !(quantized_dataset.binned_column_data(node.split_var)[row] < node.split_bin);
+			}
+			return nodes[i].value;
+		}
+
+
+		// returns the number of nodes in the tree
+		size_t size() const
+		{
+			return nodes.size();
+		}
+
+
+		// returns the nodes of the tree, where the root node is the first
+		const std::vector<Node>& get_nodes() const
+		{
+			return nodes;
+		}
+
+
+	private:
+
+		// alias for the gradient sums of each bin of each variable, indexed by variable * max_bins + bin
+		using Histogram = std::vector<GradientPair>;
+
+
+		// trains the node at the given index on a group of row indices whose histogram is given, splitting it
+		// and training its children recursively until the maximum depth is reached or no split reduces the loss
+		void grow(int node_index, std::vector<int>::iterator group_begin, std::vector<int>::iterator group_end, Histogram&& histogram, int depth)
+		{
+			// sums of the group's gradients and hessians, from the bins of any one variable
+			GradientPair total = { 0.0, 0.0 };
+			for (int bin = 0; bin < max_bins; bin++)
+			{
+				total.gradient += histogram[split_vars[0] * max_bins + bin].gradient;
+				total.hessian += histogram[split_vars[0] * max_bins + bin].hessian;
+			}
+
+			// search for the split of the group which most reduces the loss
+			int best_var = -1;
+			int best_bin = 0;
+			double best_gain = settings.min_split_gain;
+			if (depth < settings.max_depth && std::distance(group_begin, group_end) > 1)
+			{
+				double parent_score = score(total);
+				for (int col : split_vars)
+				{
+					// the left child of a split at a bin takes the rows of all the bins below it
+					GradientPair left = { 0.0, 0.0 };
+					int n_bins = dataset->get_n_bins(col);
+					for (int bin = 1; bin < n_bins; bin++)
+					{
+						left.gradient += histogram[col * max_bins + bin - 1].gradient;
+						left.hessian += histogram[col * max_bins + bin - 1].hessian;
+						GradientPair right = { total.gradient - left.gradient, total.hessian - left.hessian };
+						if (left.hessian < settings.min_child_weight || right.hessian < settings.min_child_weight)
+						{
+							continue;
+						}
+						double gain = score(left) + score(right) - parent_score;
+						if (gain > best_gain)
+						{
+							best_gain = gain;
+							best_var = col;
+							best_bin = bin;
+						}
+					}
+				}
+			}
+
+			// if no split was found, the node is a leaf whose value minimises the loss of its group,
+			// which is added to the raw score of each row of the group
+			if (best_var < 0)
+			{
+				double value = -settings.learning_rate * total.gradient / (total.hessian + settings.l2_regularization);
+				nodes[node_index] = { 0, value, 0, 0, 0 };
+				for (auto it = group_begin; it < group_end; ++it)
+				{
+					scores[*it] += value;
+				}
+				return;
+			}
+
+			// split the group, with the rows whose bin is below the split bin going to the left child
+			const uint8_t* codes = dataset->binned_column_data(best_var);
+			auto split_point = std::partition(group_begin, group_end, [codes, best_bin](int row) {
+				return codes[row] < best_bin;
+			});
+			int left_index = static_cast<int>(nodes.size());
+			nodes[node_index] = { dataset->get_bin_threshold(best_var, best_bin), 0.0, left_index,
+				static_cast<uint16_t>(best_var), static_cast<uint8_t>(best_bin) };
+			nodes.resize(nodes.size() + 2);
+
+			// build the histogram of the smaller child and derive its sibling's by subtracting it from the parent's
+			bool left_smaller = std::distance(group_begin, split_point) <= std::distance(split_point, group_end);
+			Histogram smaller = left_smaller ? build_histogram(group_begin, split_point) : build_histogram(split_point, group_end);
+			for (int col : split_vars)
+			{
+				for (int bin = 0; bin < max_bins; bin++)
+				{
+					histogram[col * max_bins + bin].gradient -= smaller[col * max_bins + bin].gradient;
+					histogram[col * max_bins + bin].hessian -= smaller[col * max_bins + bin].hessian;
+				}
+			}
+
+			// train the children
+			grow(left_index, group_begin, split_point, left_smaller ? std::move(smaller) : std::move(histogram), depth + 1);
+			grow(left_index + 1, split_point, group_end, left_smaller ? std::move(histogram) : std::move(smaller), depth + 1);
+		}
+
+
+		// builds the histogram of a group of row indices over the variables considered, with the variables
+		// divided between the threads if the group is large enough
+		Histogram build_histogram(std::vector<int>::iterator group_begin, std::vector<int>::iterator group_end) const
+		{
+			Histogram histogram(dataset->get_n_x_vars() * max_bins, { 0.0, 0.0 });
+			WorkStealingThreadPool* pool = std::distance(group_begin, group_end) >= settings.parallel_min_group_size ? thread_pool : nullptr;
+			parallel_for(pool, static_cast<int>(split_vars.size()), [&](int var) {
+				int col = split_vars[var];
+				const uint8_t* codes = dataset->binned_column_data(col);
+				GradientPair* bins = histogram.data() + col * max_bins;
+				for (auto it = group_begin; it < group_end; ++it)
+				{
+					bins[codes[*it]].gradient += gradients[*it];
+					bins[codes[*it]].hessian += hessians[*it];
+				}
+			});
+			return histogram;
+		}
+
+
+		// returns the reduction in loss from giving a group of rows its optimal value, up to a constant factor
+		double score(const GradientPair& sums) const
+		{
+			return sums.gradient * sums.gradient / (sums.hessian + settings.l2_regularization);
+		}
+
+
+		// maximum number of bins of a variable, as bin codes are stored in 8 bits
+		static const int max_bins = 256;
+
+		// nodes of the tree, where each node's children are next to each other
+		std::vector<Node> nodes = {};
+
+		// training dataset, gradients, hessians and raw scores of its rows, variables considered,
+		// settings and thread pool, which are only set while the tree is being trained
+		DecisionTreeDataset<T, dataset_x_vars>* dataset = nullptr;
+		const double* gradients = nullptr;
+		const double* hessians = nullptr;
+		double* scores = nullptr;
+		std::vector<int> split_vars = {};
+		GradientBoostingSettings settings;
+		WorkStealingThreadPool* thread_pool = nullptr;
+	};
+}
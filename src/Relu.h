@@ -5,9 +5,10 @@
 
 namespace MLComparison
 {
-	// class template for a ReLU activation function layer whose inputs are of the given dimensions
-	template<typename T, int cols>
-	class Relu : public Layer<T, cols, cols>
+	// class template for a ReLU activation function layer whose inputs are of the given dimensions,
+	// with a row for each sample of a mini-batch of the given size
+	template<typename T, int cols, size_t batch_size = 1>
+	class Relu : public Layer<T, cols, cols, batch_size>
 	{
 	public:
 
@@ -16,21 +17,30 @@ namespace MLComparison
 		{
 		}
 
+
+		// constructor for a replica of a layer, which has no parameters to share
+		Relu(const Relu&, SharedParametersTag)
+		{
+		}
+
 		
 		// forward pass which replaces all negative values with 0
-		virtual Matrix<T, 1, cols>* operator()(Matrix<T, 1, cols>* x) override
+		virtual Matrix<T, batch_size, cols>* operator()(Matrix<T, batch_size, cols>* x) override
 		{
 			// set pointer to address of matrix given as input
 			forward_record.input_matrix = x;
 			// temporary variable to hold the current element
 			T current_elem;
-			// for each column of input/output matrices
-			for (int col = 0; col < cols; col++)
+			// for each element of input/output matrices
+			for (int row = 0; row < static_cast<int>(batch_size); row++)
 			{
-				// get element from input matrix
-				current_elem = x->at(0)[col];
-				// set element of output matrix to current item if positive, else 0
-				forward_record.output_matrix[0][col] = current_elem > 0 ? current_elem - 0.5 : -0.5;
+				for (int col = 0; col < cols; col++)
+				{
+					// get element from input matrix
+					current_elem = x->at(row)[col];
+					// set element of output matrix to current item if positive, else 0
+					forward_record.output_matrix[row][col] = activate(current_elem);
+				}
 			}
 
 			// return pointer to output matrix
@@ -41,20 +51,47 @@ namespace MLComparison
 		// backward pass which sets gradient of each input to gradient of output if the input is positive, else 0
 		void backward() override
 		{
-			// GradMatrix pointer to input matrix
-			auto* grad_input_ptr = static_cast<GradMatrix<T, 1, cols>*>(forward_record.input_matrix);
-			// for each column of input.output matrices
-			for (int col = 0; col < cols; col++)
+			backward(static_cast<GradMatrix<T, batch_size, cols>*>(forward_record.input_matrix));
+		}
+
+
+		// backward pass given the input matrix of the forward pass as a gradient-enabled matrix, or a null
+		// pointer if its gradients are not needed
+		void backward(GradMatrix<T, batch_size, cols>* grad_input_ptr)
+		{
+			if (grad_input_ptr == nullptr)
+			{
+				return;
+			}
+			// for each element of input/output matrices
+			for (int row = 0; row < static_cast<int>(batch_size); row++)
 			{
-				// gradient of input is gradient of corresponding output if input is positive, otherwise 0
-				grad_input_ptr->grad[0][col] = forward_record.input_matrix->at(0)[col] > 0 ? forward_record.output_matrix.grad[0][col] : 0;
+				for (int col = 0; col < cols; col++)
+				{
+					// gradient of input is gradient of corresponding output if input is positive, otherwise 0
+					grad_input_ptr->grad[row][col] = forward_record.input_matrix->at(row)[col] > 0 ? forward_record.output_matrix.grad[row][col] : 0;
+				}
 			}
 		}
 
 
+		// activation function, which replaces a negative value with 0, with outputs shifted down by 0.5
+		static T activate(T x)
+		{
+			return x > 0 ? x - 0.5 : -0.5;
+		}
+
+
+		// derivative of the activation function given its input and output
+		static T derivative(T x, T)
+		{
+			return x > 0 ? 1 : 0;
+		}
+
+
 	private:
 
 		// record of forward pass
-		ForwardRecord<T, cols, cols> forward_record;
+		ForwardRecord<T, cols, cols, batch_size> forward_record;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "base_layers.h"
+
+
+namespace MLComparison
+{
+	// class template for a neural network made up of a chain of layers whose types are all known at compile time,
+	// each of whose inputs are the outputs of the layer before it; the layers are called by their own types rather
+	// than through the virtual functions of Layer, and each is given its gradient-enabled input matrix by the network
+	// in the backward pass rather than finding it with a run-time type check, so that the compiler can inline the
+	// whole forward and backward pass; the network is made up of its first layer followed by a network of the rest
+	template<typename... Layers>
+	class Sequential;
+
+
+	// specialization for an empty chain of layers, which ends every network and passes its inputs through unchanged
+	template<>
+	class Sequential<>
+	{
+	public:
+
+		// default constructor
+		Sequential()
+		{
+		}
+
+
+		// constructor for a replica of a network
+		Sequential(Sequential&, SharedParametersTag)
+		{
+		}
+
+
+		// forward pass which returns the inputs
+		template<typename MatrixType>
+		MatrixType* operator()(MatrixType* x)
+		{
+			return x;
+		}
+
+
+		// backward pass, for which there is nothing to do
+		template<typename GradMatrixType>
+		void backward(GradMatrixType*)
+		{
+		}
+
+
+		// update of the parameters, of which there are none
+		void update()
+		{
+		}
+
+
+		// setter for the learning rate, which no layer uses
+		template<typename LearningRateType>
+		void set_lr(LearningRateType)
+		{
+		}
+	};
+
+
+	// specialization for a chain of at least one layer
+	template<typename FirstLayer, typename... OtherLayers>
+	class Sequential<FirstLayer, OtherLayers...>
+	{
+	public:
+
+		// types of the elements and of the input matrix of the network, which are those of its first layer,
+		// and of its output matrix, which is that returned by the network of the other layers
+		using value_type = typename FirstLayer::value_type;
+		using input_type = typename FirstLayer::input_type;
+		using grad_input_type = typename FirstLayer::grad_input_type;
+		using output_type = typename std::remove_pointer<decltype(std::declval<Sequential<OtherLayers...>&>()(
+			std::declval<typename FirstLayer::output_type*>()))>::type;
+
+
+		// default constructor
+		Sequential()
+		{
+		}
+
+
+		// constructor which sets the learning rate of each trainable layer
+		Sequential(value_type learning_rate)
+		{
+			set_lr(learning_rate);
+		}
+
+
+		// constructor which creates a replica of a network, whose layers are replicas of its layers
+		Sequential(Sequential& shared_network, SharedParametersTag tag) :
+			layer(shared_network.layer, tag),
+			other_layers(shared_network.other_layers, tag)
+		{
+		}
+
+
+		// forward pass which calls each layer on the outputs of the one before it and returns the outputs of the last
+		output_type* operator()(input_type* x)
+		{
+			first_layer_outputs = layer.FirstLayer::operator()(x);
+			return other_layers(first_layer_outputs);
+		}
+
+
+		// backward pass for inputs whose gradients are not needed, such as rows of a dataset
+		void backward()
+		{
+			backward(nullptr);
+		}
+
+
+		// backward pass which calls each layer's backward pass in reverse order, given the input matrix of the forward
+		// pass as a gradient-enabled matrix, or a null pointer if its gradients are not needed; the outputs of each
+		// layer are the gradient-enabled matrix of its forward record, whose gradients the next layer sets
+		void backward(grad_input_type* grad_input_ptr)
+		{
+			other_layers.backward(static_cast<typename FirstLayer::grad_output_type*>(first_layer_outputs));
+			layer.FirstLayer::backward(grad_input_ptr);
+		}
+
+
+		// updates the parameters of each trainable layer
+		void update()
+		{
+			update_layer(std::integral_constant<bool, FirstLayer::is_trainable>());
+			other_layers.update();
+		}
+
+
+		// sets the learning rate of each trainable layer
+		void set_lr(value_type new_learning_rate)
+		{
+			set_layer_lr(new_learning_rate, std::integral_constant<bool, FirstLayer::is_trainable>());
+			other_layers.set_lr(new_learning_rate);
+		}
+
+
+		// returns the layer at the given index of the chain
+		template<size_t index>
+		auto& get()
+		{
+			return get_layer(std::integral_constant<size_t, index>());
+		}
+
+
+		// returns the layer at the given index of the chain
+		template<size_t index>
+		const auto& get() const
+		{
+			return get_layer(std::integral_constant<size_t, index>());
+		}
+
+
+	private:
+
+		// updates the parameters of the first layer if it is trainable
+		void update_layer(std::true_type)
+		{
+			layer.FirstLayer::update();
+		}
+
+
+		// overload for a first layer which is not trainable
+		void update_layer(std::false_type)
+		{
+		}
+
+
+		// sets the learning rate of the first layer if it is trainable
+		void set_layer_lr(value_type new_learning_rate, std::true_type)
+		{
+			layer.FirstLayer::set_lr(new_learning_rate);
+		}
+
+
+		// overload for a first layer which is not trainable
+		void set_layer_lr(value_type, std::false_type)
+		{
+		}
+
+
+		// returns the first layer
+		FirstLayer& get_layer(std::integral_constant<size_t, 0>)
+		{
+			return layer;
+		}
+
+
+		// returns the first layer
+		const FirstLayer& get_layer(std::integral_constant<size_t, 0>) const
+		{
+			return layer;
+		}
+
+
+		// returns a layer after the first, from the network of the other layers
+		template<size_t index>
+		auto& get_layer(std::integral_constant<size_t, index>)
+		{
+			return other_layers.template get<index - 1>();
+		}
+
+
+		// returns a layer after the first, from the network of the other layers
+		template<size_t index>
+		const auto& get_layer(std::integral_constant<size_t, index>) const
+		{
+			return other_layers.template get<index - 1>();
+		}
+
+
+		// first layer of the chain
+		FirstLayer layer;
+		// network of the other layers, which takes the outputs of the first layer as its inputs
+		Sequential<OtherLayers...> other_layers;
+		// outputs of the first layer in the last forward pass
+		typename FirstLayer::output_type* first_layer_outputs = nullptr;
+	};
+}
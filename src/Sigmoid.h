@@ -7,9 +7,10 @@
 
 namespace MLComparison
 {
-	// class template for a sigmoid activation function layer whose inputs are of the given dimensions
-	template<typename T, int cols>
-	class Sigmoid : public Layer<T, cols, cols>
+	// class template for a sigmoid activation function layer whose inputs are of the given dimensions,
+	// with a row for each sample of a mini-batch of the given size
+	template<typename T, int cols, size_t batch_size = 1>
+	class Sigmoid : public Layer<T, cols, cols, batch_size>
 	{
 	public:
 
@@ -19,16 +20,25 @@ namespace MLComparison
 		}
 
 
+		// constructor for a replica of a layer, which has no parameters to share
+		Sigmoid(const Sigmoid&, SharedParametersTag)
+		{
+		}
+
+
 		// forward pass which applies the sigmoid function to each input element
-		virtual Matrix<T, 1, cols>* operator()(Matrix<T, 1, cols>* x) override
+		virtual Matrix<T, batch_size, cols>* operator()(Matrix<T, batch_size, cols>* x) override
 		{
 			// set pointer to address of matrix given as input
 			forward_record.input_matrix = x;
-			// for each column of input/output matrices
-			for (int col = 0; col < cols; col++)
+			// for each element of input/output matrices
+			for (int row = 0; row < static_cast<int>(batch_size); row++)
 			{
-				// set element of output matrix to current item if positive, else 0
-				forward_record.output_matrix[0][col] = sigmoid(x->at(0)[col]);
+				for (int col = 0; col < cols; col++)
+				{
+					// set element of output matrix to sigmoid of current item
+					forward_record.output_matrix[row][col] = activate(x->at(row)[col]);
+				}
 			}
 			// return reference to output matrix
 			return &forward_record.output_matrix;
@@ -39,31 +49,51 @@ namespace MLComparison
 		// and derivative of sigmoid function
 		virtual void backward() override
 		{
-			// GradMatrix pointer to input matrix
-			auto* grad_input_ptr = static_cast<GradMatrix<T, 1, cols>*>(forward_record.input_matrix);
+			backward(static_cast<GradMatrix<T, batch_size, cols>*>(forward_record.input_matrix));
+		}
+
+
+		// backward pass given the input matrix of the forward pass as a gradient-enabled matrix, or a null
+		// pointer if its gradients are not needed
+		void backward(GradMatrix<T, batch_size, cols>* grad_input_ptr)
+		{
+			if (grad_input_ptr == nullptr)
+			{
+				return;
+			}
 			// temporary variable for current element of input matrix
 			T current_elem;
-			// for each column of input.output matrices
-			for (int col = 0; col < cols; col++)
+			// for each element of input/output matrices
+			for (int row = 0; row < static_cast<int>(batch_size); row++)
 			{
-				current_elem = forward_record.input_matrix->at(0)[col];
-				// gradient of input is derivative of sigmoid function times gradient of corresponding output
-				grad_input_ptr->grad[0][col] = sigmoid(current_elem) * (1 - sigmoid(current_elem)) * forward_record.output_matrix.grad[0][col];
+				for (int col = 0; col < cols; col++)
+				{
+					current_elem = forward_record.input_matrix->at(row)[col];
+					// gradient of input is derivative of sigmoid function times gradient of corresponding output
+					grad_input_ptr->grad[row][col] = activate(current_elem) * (1 - activate(current_elem)) * forward_record.output_matrix.grad[row][col];
+				}
 			}
 		}
 
 
-	private:
-
 		// sigmoid function
-		T sigmoid(T x)
+		static T activate(T x)
 		{
 			// 1 / (1 + e^-x)
 			return 1 / (1 + std::exp(-x));
 		}
 
 
+		// derivative of the sigmoid function given its input and output, which is sigmoid(x) * (1 - sigmoid(x))
+		static T derivative(T, T y)
+		{
+			return y * (1 - y);
+		}
+
+
+	private:
+
 		// record of forward pass
-		ForwardRecord<T, cols, cols> forward_record;
+		ForwardRecord<T, cols, cols, batch_size> forward_record;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <iterator>
+#include <iostream>
+#include <utility>
+#include <cstdint>
+#include <algorithm>
+
+
+namespace MLComparison
+{
+	// struct for a view of the independent variables of a row of a sparse dataset, i.e. the columns and values of
+	// its non-zero entries in ascending order of column, which are stored by the dataset, and its number of columns
+	template<typename T>
+	struct SparseRow
+	{
+		// returns the value of the given column, which is zero unless it is one of the row's non-zero entries
+		T operator[](int col) const
+		{
+			const uint32_t* entry = std::lower_bound(cols, cols + nnz, static_cast<uint32_t>(col));
+			return entry != cols + nnz && *entry == static_cast<uint32_t>(col) ? values[entry - cols] : T(0);
+		}
+
+
+		// returns the number of columns of the row, i.e. of independent variables in the dataset
+		int size() const
+		{
+			return width;
+		}
+
+
+		// columns and values of the non-zero entries
+		const uint32_t* cols;
+		const T* values;
+		// number of non-zero entries
+		int nnz;
+		// number of columns
+		int width;
+	};
+
+
+	// class template for a dataset whose independent variables are mostly zero, stored in compressed sparse row
+	// format, i.e. the columns and values of the non-zero entries of all the rows in one pair of arrays, in which each
+	// row's entries start at its offset, so that memory and the cost of scanning the rows scale with the number of
+	// non-zero entries rather than the width; the number of independent variables is read from the csv file, and each
+	// row is a pair of a view of its entries and its dependent variable, suitable for a neural network model
+	template<typename T>
+	class SparseDataset
+	{
+	public:
+
+		// default constructor which leaves the dataset unpopulated
+		SparseDataset()
+		{
+		}
+
+
+		// constructor which takes the name of a csv file to load
+		SparseDataset(const std::string& csv_file)
+		{
+			load_data(csv_file);
+		}
+
+
+		// the rows are views of the dataset's arrays, which a copy would not share, so it is not copyable, while a
+		// move keeps the arrays' storage and so the views
+		SparseDataset(const SparseDataset&) = delete;
+		SparseDataset& operator=(const SparseDataset&) = delete;
+		SparseDataset(SparseDataset&&) = default;
+		SparseDataset& operator=(SparseDataset&&) = default;
+
+
+		// element access operator which returns row i
+		auto& operator[](int i)
+		{
+			return data_table[i];
+		}
+
+
+		// const element access operator
+		const auto& operator[](int i) const
+		{
+			return data_table[i];
+		}
+
+
+		// element access method
+		auto& at(int i)
+		{
+			return data_table[i];
+		}
+
+
+		// const element access method
+		const auto& at(int i) const
+		{
+			return data_table[i];
+		}
+
+
+		// returns an iterator pointing to the first row
+		auto begin()
+		{
+			return data_table.begin();
+		}
+
+
+		// returns an iterator pointing to the past-the-end row
+		auto end()
+		{
+			return data_table.end();
+		}
+
+
+		// returns an end iterator based on a number of rows to use
+		auto end(size_t rows_to_use)
+		{
+			if (rows_to_use < data_table.size())
+			{
+				auto end_iterator = data_table.begin();
+				std::advance(end_iterator, rows_to_use);
+				return end_iterator;
+			}
+			else
+			{
+				return data_table.end();
+			}
+		}
+
+
+		// returns the number of rows in the dataset
+		auto size() const
+		{
+			return data_table.size();
+		}
+
+
+		// returns the number of independent variables in the dataset
+		int get_n_x_vars() const
+		{
+			return n_x_vars;
+		}
+
+
+		// returns the total number of non-zero entries of the independent variables
+		size_t get_nnz() const
+		{
+			return entry_values.size();
+		}
+
+
+		// loads data from a csv file whose last field is the dependent variable, storing only the non-zero
+		// entries of the independent variables
+		void load_data(const std::string& csv_file)
+		{
+			// clear the rows and their entries
+			data_table.clear();
+			row_offsets.assign(1, 0);
+			entry_cols.clear();
+			entry_values.clear();
+			labels.clear();
+			// open csv file
+			std::ifstream infile(csv_file);
+			// create string and stream to store each line in turn
+			std::string line;
+			std::istringstream line_stream;
+			// create variable for each field
+			std::string item;
+			// for each row
+			for (int row = 0; std::getline(infile, line); row++)
+			{
+				// count the independent variables in the first line
+				if (row == 0)
+				{
+					n_x_vars = static_cast<int>(std::count(line.begin(), line.end(), ','));
+				}
+				// create stream for line
+				line_stream = std::istringstream(line);
+				// store the column and value of each non-zero independent variable
+				for (int col = 0; col < n_x_vars; col++)
+				{
+					std::getline(line_stream, item, ',');
+					T value = static_cast<T>(std::stod(item));
+					if (value != 0)
+					{
+						entry_cols.push_back(static_cast<uint32_t>(col));
+						entry_values.push_back(value);
+					}
+				}
+				row_offsets.push_back(entry_values.size());
+				// get dependent variable
+				std::getline(line_stream, item, ',');
+				labels.push_back(static_cast<T>(std::stod(item)));
+			}
+
+			// create the view of each row once its entries are stored, as they do not move after that
+			data_table.reserve(labels.size());
+			for (size_t row = 0; row < labels.size(); row++)
+			{
+				SparseRow<T> view = { entry_cols.data() + row_offsets[row], entry_values.data() + row_offsets[row],
+					static_cast<int>(row_offsets[row + 1] - row_offsets[row]), n_x_vars };
+				data_table.emplace_back(view, labels[row]);
+			}
+		}
+
+
+		// outputs the non-zero entries of each row as column:value pairs followed by the dependent variable
+		void print()
+		{
+			for (auto& row : data_table)
+			{
+				for (int i = 0; i < row.first.nnz; i++)
+				{
+					std::cout << row.first.cols[i] << ":" << row.first.values[i] << " ";
+				}
+				std::cout << row.second << std::endl;
+			}
+		}
+
+
+	private:
+
+		// number of independent variables in the dataset
+		int n_x_vars = 0;
+
+		// index of the first non-zero entry of each row, followed by the total number of entries
+		std::vector<size_t> row_offsets = { 0 };
+		// columns and values of the non-zero entries, row by row
+		std::vector<uint32_t> entry_cols = {};
+		std::vector<T> entry_values = {};
+		// dependent variable of each row
+		std::vector<T> labels = {};
+
+		// view of the entries of each row paired with its dependent variable
+		std::vector<std::pair<SparseRow<T>, T>> data_table = {};
+	};
+}
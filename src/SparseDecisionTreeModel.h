@@ -0,0 +1,378 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <algorithm>
+
+#include "SparseDataset.h"
+#include "DecisionTreeSettings.h"
+#include "FlatDecisionTree.h"
+#include "NodeArena.h"
+#include "calculate_rows_to_use.h"
+
+
+namespace MLComparison
+{
+	// class template for a decision tree prediction model suitable for binary classification, trained on a sparse
+	// dataset; each node's split search gathers the non-zero entries of its group's rows, sorts them by variable and
+	// value, and sweeps each variable's entries with the group's implicit zeros counted as a single bucket, whose size
+	// and class value sum are those of the group less its non-zero entries, so that training costs scale with the number
+	// of non-zero entries rather than the width; the tree is grown depth first with the maximum depth and minimum split
+	// group size of its settings, and compiled into a contiguous array of nodes from which predictions are made
+	template<typename T>
+	class SparseDecisionTreeModel
+	{
+	public:
+
+		// default constructor
+		SparseDecisionTreeModel()
+		{
+		}
+
+
+		// constructor which takes the names of csv files for the training and validation sets
+		SparseDecisionTreeModel(const std::string& train_csv, const std::string& valid_csv) :
+			training_set(train_csv),
+			validation_set(valid_csv)
+		{
+		}
+
+
+		// get accuracy
+		T get_accuracy()
+		{
+			return validation_accuracy;
+		}
+
+
+		// get training settings
+		const DecisionTreeSettings& get_settings()
+		{
+			return settings;
+		}
+
+
+		// set training settings, which apply from the next call to train
+		void set_settings(const DecisionTreeSettings& new_settings)
+		{
+			settings = new_settings;
+		}
+
+
+		// loads a csv file as the training set
+		void load_training_set_file(const std::string& csv_file)
+		{
+			training_set.load_data(csv_file);
+		}
+
+
+		// loads a csv file as the validation set
+		void load_validation_set_file(const std::string& csv_file)
+		{
+			validation_set.load_data(csv_file);
+		}
+
+
+		// trains the model using a certain proportion of the training samples
+		// and a given number of fields within these samples
+		long long train(uint8_t eighths_rows_to_use, size_t x_vars_to_use)
+		{
+			// number of rows to use
+			size_t rows_to_use = calculate_rows_to_use(8, eighths_rows_to_use, training_set.size());
+			// number of fields to use, which cannot exceed the number in the training set
+			n_x_vars_to_use = static_cast<int>(std::min(x_vars_to_use, static_cast<size_t>(training_set.get_n_x_vars())));
+
+			// get start time
+			the_clock::time_point start = the_clock::now();
+
+			// indices of the rows to use, which are partitioned between the nodes as the tree is grown
+			std::vector<int> row_indices(rows_to_use);
+			std::iota(row_indices.begin(), row_indices.end(), 0);
+
+			// free any previous tree and grow the tree from its root node
+			nodes.clear();
+			root_node_ptr = nodes.create();
+			grow(*root_node_ptr, row_indices.begin(), row_indices.end(), 0);
+			// the buffer of entries is only needed during training
+			entries = std::vector<Entry>();
+
+			// get end time
+			the_clock::time_point end = the_clock::now();
+
+			// compile the trained tree into the flat layout used for prediction
+			flat_tree.compile(*root_node_ptr);
+
+			// return number of nanoseconds taken
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+		}
+
+
+		// method template for making a prediction based on a sample using the compiled tree
+		template<typename SampleType>
+		int predict(const SampleType& sample) const
+		{
+			return flat_tree.predict(sample);
+		}
+
+
+		// returns the compiled decision tree
+		const FlatDecisionTree& get_flat_tree() const
+		{
+			return flat_tree;
+		}
+
+
+		// determine the model's accuracy using the validation set
+		long long validate(uint8_t eighths_rows_to_use)
+		{
+			// number of rows to use
+			size_t rows_to_use = calculate_rows_to_use(8, eighths_rows_to_use, validation_set.size());
+
+			// total correct predictions
+			T total_correct = 0;
+
+			// get start time
+			the_clock::time_point start = the_clock::now();
+
+			// for each sample in the validation set to use, add whether the prediction is correct
+			for (size_t i = 0; i < rows_to_use; i++)
+			{
+				total_correct += (flat_tree.predict(validation_set[i].first) == validation_set[i].second);
+			}
+
+			// get end time
+			the_clock::time_point end = the_clock::now();
+
+			// for each sample in the validation set, add whether the prediction is correct
+			total_correct = 0;
+			for (size_t i = 0; i < validation_set.size(); i++)
+			{
+				total_correct += (flat_tree.predict(validation_set[i].first) == validation_set[i].second);
+			}
+
+			// calculate and record validation accuracy
+			validation_accuracy = total_correct / validation_set.size();
+
+			// return number of nanoseconds taken
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+		}
+
+
+	private:
+
+		// struct for a node of the tree, with the accessors from which it is compiled
+		struct Node
+		{
+			bool is_leaf() const
+			{
+				return left == nullptr;
+			}
+
+			int get_class_prediction() const
+			{
+				return class_prediction;
+			}
+
+			int get_split_var() const
+			{
+				return split_var;
+			}
+
+			T get_split_val() const
+			{
+				return split_val;
+			}
+
+			const Node* get_left() const
+			{
+				return left;
+			}
+
+			const Node* get_right() const
+			{
+				return right;
+			}
+
+			// split variable and value if the node is not a leaf
+			int split_var = -1;
+			T split_val = -1;
+			// class prediction if the node is a leaf
+			int class_prediction = -1;
+			// pointers to left and right child nodes, which are owned by the model's node arena
+			Node* left = nullptr;
+			Node* right = nullptr;
+		};
+
+
+		// struct for a non-zero entry of a row of a node's group, with the row's class value
+		struct Entry
+		{
+			T value;
+			uint32_t col;
+			uint32_t class_val;
+		};
+
+
+		// trains a node on a group of row indices, splitting it and training its children recursively until the
+		// maximum depth is reached, the group is too small or no split lowers the Gini index below 0.5
+		void grow(Node& node, std::vector<int>::iterator group_begin, std::vector<int>::iterator group_end, int depth)
+		{
+			// size and class value sum of the group
+			int group_size = static_cast<int>(std::distance(group_begin, group_end));
+			int class_val_sum = 0;
+			for (auto it = group_begin; it < group_end; ++it)
+			{
+				class_val_sum += static_cast<int>(training_set[*it].second);
+			}
+
+			// search for the best split point if depth is low enough and group size large enough
+			int best_var = -1;
+			T best_val = 0;
+			if (depth < settings.max_depth && group_size >= settings.min_split_group_size)
+			{
+				find_best_split(group_begin, group_end, group_size, class_val_sum, best_var, best_val);
+			}
+
+			// become a leaf node if no split was found, predicting whichever class is more prevalent
+			if (best_var < 0)
+			{
+				node.class_prediction = (class_val_sum > group_size / 2) ? 1 : 0;
+				return;
+			}
+
+			// otherwise, partition the group, with the rows whose value is below the split value going to the
+			// left child, and create and train the child nodes
+			auto split_point = std::partition(group_begin, group_end, [this, best_var, best_val](int row) {
+				return training_set[row].first[best_var] < best_val;
+			});
+			node.split_var = best_var;
+			node.split_val = best_val;
+			node.left = nodes.create();
+			node.right = nodes.create();
+			grow(*node.left, group_begin, split_point, depth + 1);
+			grow(*node.right, split_point, group_end, depth + 1);
+		}
+
+
+		// finds the split point with the lowest Gini index below 0.5 among the values of the variables to use in a
+		// group of rows, or leaves best_var at -1 if there is none; a split point sends the rows whose value is below
+		// its value to the left, and ties are broken by the lower variable, then the lower value
+		void find_best_split(std::vector<int>::iterator group_begin, std::vector<int>::iterator group_end, int group_size,
+			int class_val_sum, int& best_var, T& best_val)
+		{
+			// gather the non-zero entries of the variables to use and sort them by variable, then by value
+			entries.clear();
+			for (auto it = group_begin; it < group_end; ++it)
+			{
+				const SparseRow<T>& row = training_set[*it].first;
+				uint32_t class_val = static_cast<uint32_t>(training_set[*it].second);
+				for (int i = 0; i < row.nnz && row.cols[i] < static_cast<uint32_t>(n_x_vars_to_use); i++)
+				{
+					entries.push_back({ row.values[i], row.cols[i], class_val });
+				}
+			}
+			std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+				return a.col != b.col ? a.col < b.col : a.value < b.value;
+			});
+
+			double best_gini_index = 0.5;
+			// for each variable's run of entries, as a variable with none in the group cannot split it
+			for (auto run_begin = entries.begin(); run_begin != entries.end();)
+			{
+				uint32_t col = run_begin->col;
+				auto run_end = std::find_if(run_begin, entries.end(), [col](const Entry& entry) { return entry.col != col; });
+
+				// the implicit zeros of the variable are the rows of the group without an entry for it
+				int zero_size = group_size - static_cast<int>(std::distance(run_begin, run_end));
+				int zero_class_val_sum = class_val_sum;
+				for (auto it = run_begin; it < run_end; ++it)
+				{
+					zero_class_val_sum -= it->class_val;
+				}
+
+				// sweep the values in ascending order, with the zero bucket added in one step between the negative and
+				// positive values, evaluating each distinct value as a split point with the values below it on the left
+				int left_size = 0;
+				int left_class_val_sum = 0;
+				T last_value = 0;
+				bool zeros_added = zero_size == 0;
+				auto consider = [&](T value) {
+					double gini_index = calculate_gini_index(group_size, class_val_sum, left_size, left_class_val_sum);
+					if (gini_index < best_gini_index)
+					{
+						best_gini_index = gini_index;
+						best_var = static_cast<int>(col);
+						best_val = value;
+					}
+				};
+				for (auto it = run_begin; it < run_end; ++it)
+				{
+					if (!zeros_added && it->value > 0)
+					{
+						if (left_size > 0)
+						{
+							consider(0);
+						}
+						left_size += zero_size;
+						left_class_val_sum += zero_class_val_sum;
+						last_value = 0;
+						zeros_added = true;
+					}
+					if (left_size > 0 && it->value != last_value)
+					{
+						consider(it->value);
+					}
+					left_size++;
+					left_class_val_sum += it->class_val;
+					last_value = it->value;
+				}
+				if (!zeros_added)
+				{
+					consider(0);
+				}
+
+				run_begin = run_end;
+			}
+		}
+
+
+		// calculates the Gini index of a split point from the size and class value sum of the group and its left subgroup
+		static double calculate_gini_index(int group_size, int class_val_sum, int left_size, int left_class_val_sum)
+		{
+			// each subgroup's Gini index, 2 * p * (1 - p), weighted by its proportion of the group
+			double left_impurity = 2.0 * left_class_val_sum * (left_size - left_class_val_sum) / left_size;
+			int right_size = group_size - left_size;
+			int right_class_val_sum = class_val_sum - left_class_val_sum;
+			double right_impurity = 2.0 * right_class_val_sum * (right_size - right_class_val_sum) / right_size;
+			return (left_impurity + right_impurity) / group_size;
+		}
+
+
+		// accuracy of the model on the validation set
+		T validation_accuracy = 0;
+		// settings which control how the decision tree is trained
+		DecisionTreeSettings settings;
+		// number of independent variables used by the last training
+		int n_x_vars_to_use = 0;
+
+		// training and validation sets
+		SparseDataset<T> training_set;
+		SparseDataset<T> validation_set;
+
+		// arena which owns the nodes of the decision tree, and a pointer to its root node
+		NodeArena<Node> nodes;
+		Node* root_node_ptr = nullptr;
+		// non-zero entries of the group of the node whose split is being searched, reused between nodes
+		std::vector<Entry> entries = {};
+
+		// the trained decision tree compiled into a contiguous array of nodes for prediction
+		FlatDecisionTree flat_tree;
+
+		// alias for chrono::steady_clock used for performance measurement
+		using the_clock = std::chrono::steady_clock;
+	};
+}
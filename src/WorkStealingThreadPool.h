@@ -0,0 +1,318 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+
+namespace MLComparison
+{
+	// class for a pool of worker threads which each keep their own queue of tasks, taking the most recently
+	// submitted task from their own queue and, when it is empty, stealing the oldest task from another queue,
+	// which suits recursive divide-and-conquer work such as building the subtrees of a decision tree
+	class WorkStealingThreadPool
+	{
+	public:
+
+		// constructor which starts the given number of worker threads
+		explicit WorkStealingThreadPool(unsigned int n_workers = std::thread::hardware_concurrency())
+		{
+			// one queue per worker and one shared by threads outside the pool
+			for (unsigned int i = 0; i <= n_workers; i++)
+			{
+				queues.emplace_back(new TaskQueue);
+			}
+			// start the workers
+			for (unsigned int i = 0; i < n_workers; i++)
+			{
+				workers.emplace_back(&WorkStealingThreadPool::worker_loop, this, i);
+			}
+		}
+
+
+		// destructor which waits for the worker threads to finish their current tasks and stop
+		~WorkStealingThreadPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(sleep_mutex);
+				stopping = true;
+			}
+			wake_workers.notify_all();
+			for (auto& worker : workers)
+			{
+				worker.join();
+			}
+		}
+
+
+		// the pool owns running threads, so it is neither copyable nor assignable
+		WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+		WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+
+
+		// returns the number of worker threads
+		size_t size() const
+		{
+			return workers.size();
+		}
+
+
+		// submits a task, which is pushed onto the calling worker's own queue or, if the calling
+		// thread is not one of the pool's workers, onto the shared queue
+		void submit(std::function<void()> task)
+		{
+			TaskQueue& queue = *queues[own_queue_index()];
+			{
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				queue.tasks.push_back(std::move(task));
+			}
+			++n_queued;
+			wake_workers.notify_one();
+		}
+
+
+		// runs one queued task if there is one, taking the newest task from the calling thread's own queue
+		// or else the oldest task from another queue, and returns whether a task was run
+		bool run_pending_task()
+		{
+			std::function<void()> task;
+			if (try_pop(task))
+			{
+				task();
+				return true;
+			}
+			return false;
+		}
+
+
+	private:
+
+		// struct for a queue of tasks guarded by a mutex
+		struct TaskQueue
+		{
+			std::mutex mutex;
+			std::deque<std::function<void()>> tasks;
+		};
+
+
+		// returns the index of the calling thread's own queue, which for threads outside the pool is the shared queue
+		size_t own_queue_index() const
+		{
+			return current_pool() == this ? current_worker_index() : workers.size();
+		}
+
+
+		// takes a task from the calling thread's own queue or steals one from another, returning whether one was found
+		bool try_pop(std::function<void()>& task)
+		{
+			size_t own_index = own_queue_index();
+			// newest task of the calling thread's own queue
+			{
+				TaskQueue& queue = *queues[own_index];
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				if (!queue.tasks.empty())
+				{
+					task = std::move(queue.tasks.back());
+					queue.tasks.pop_back();
+					--n_queued;
+					return true;
+				}
+			}
+			// oldest task of each other queue in turn, starting with the next one along
+			for (size_t offset = 1; offset < queues.size(); offset++)
+			{
+				TaskQueue& queue = *queues[(own_index + offset) % queues.size()];
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				if (!queue.tasks.empty())
+				{
+					task = std::move(queue.tasks.front());
+					queue.tasks.pop_front();
+					--n_queued;
+					return true;
+				}
+			}
+			return false;
+		}
+
+
+		// loop run by each worker thread, which runs tasks until the pool is stopped and sleeps when there are none
+		void worker_loop(size_t worker_index)
+		{
+			current_pool() = this;
+			current_worker_index() = worker_index;
+			while (true)
+			{
+				if (run_pending_task())
+				{
+					continue;
+				}
+				std::unique_lock<std::mutex> lock(sleep_mutex);
+				if (stopping)
+				{
+					return;
+				}
+				// wait with a timeout, as a task may be queued between the check above and the wait
+				wake_workers.wait_for(lock, std::chrono::milliseconds(1), [this] { return stopping || n_queued > 0; });
+			}
+		}
+
+
+		// worker threads
+		std::vector<std::thread> workers;
+		// task queue of each worker followed by the shared queue
+		std::vector<std::unique_ptr<TaskQueue>> queues;
+
+		// number of tasks in all the queues
+		std::atomic<int> n_queued{ 0 };
+		// whether the pool is being destroyed
+		bool stopping = false;
+		// mutex and condition variable with which idle workers sleep
+		std::mutex sleep_mutex;
+		std::condition_variable wake_workers;
+
+		// returns a reference to the pool of the worker running on the current thread, if any
+		static const WorkStealingThreadPool*& current_pool()
+		{
+			thread_local const WorkStealingThreadPool* pool = nullptr;
+			return pool;
+		}
+
+
+		// returns a reference to the queue index of the worker running on the current thread
+		static size_t& current_worker_index()
+		{
+			thread_local size_t index = 0;
+			return index;
+		}
+	};
+
+
+	// class for a group of tasks submitted to a work-stealing thread pool which can be waited on together,
+	// with the waiting thread running queued tasks rather than blocking, so that tasks may wait on their own subtasks;
+	// an exception thrown by a task is caught on the thread which ran it and the first one is rethrown by wait
+	class TaskGroup
+	{
+	public:
+
+		// constructor which takes the pool to which tasks are submitted
+		explicit TaskGroup(WorkStealingThreadPool& thread_pool) : pool(thread_pool)
+		{
+		}
+
+
+		// destructor which waits for any unfinished tasks, as they may refer to the caller's variables, without
+		// rethrowing their exceptions, as it may be called while another exception is propagating
+		~TaskGroup()
+		{
+			wait_for_tasks();
+		}
+
+
+		// submits a task to the pool as part of the group, which is counted as finished even if it throws
+		void run(std::function<void()> task)
+		{
+			++n_unfinished;
+			pool.submit([this, task]() {
+				FinishGuard guard{ n_unfinished };
+				try
+				{
+					task();
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lock(exception_mutex);
+					if (first_exception == nullptr)
+					{
+						first_exception = std::current_exception();
+					}
+				}
+			});
+		}
+
+
+		// waits until all the group's tasks have finished, running queued tasks in the meantime, and then rethrows
+		// the first exception thrown by any of them
+		void wait()
+		{
+			wait_for_tasks();
+			std::exception_ptr exception = nullptr;
+			{
+				std::lock_guard<std::mutex> lock(exception_mutex);
+				std::swap(exception, first_exception);
+			}
+			if (exception != nullptr)
+			{
+				std::rethrow_exception(exception);
+			}
+		}
+
+
+	private:
+
+		// struct which counts a task as finished when it goes out of scope
+		struct FinishGuard
+		{
+			std::atomic<int>& n_unfinished;
+
+
+			// destructor which counts the task as finished
+			~FinishGuard()
+			{
+				--n_unfinished;
+			}
+		};
+
+
+		// waits until all the group's tasks have finished, running queued tasks in the meantime
+		void wait_for_tasks()
+		{
+			while (n_unfinished > 0)
+			{
+				if (!pool.run_pending_task())
+				{
+					std::this_thread::yield();
+				}
+			}
+		}
+
+
+		// pool to which tasks are submitted
+		WorkStealingThreadPool& pool;
+
+		// number of the group's tasks which have not finished
+		std::atomic<int> n_unfinished{ 0 };
+		// first exception thrown by any of the group's tasks, and the mutex which guards it
+		std::exception_ptr first_exception = nullptr;
+		std::mutex exception_mutex;
+	};
+
+
+	// function template which calls a function with each index from 0 to n_tasks - 1, as tasks on the given thread
+	// pool with the calling thread running the first and then helping with the rest, or serially if the pool is null
+	template<typename Function>
+	void parallel_for(WorkStealingThreadPool* pool, int n_tasks, Function function)
+	{
+		if (pool == nullptr || n_tasks <= 1)
+		{
+			for (int i = 0; i < n_tasks; i++)
+			{
+				function(i);
+			}
+			return;
+		}
+		TaskGroup tasks(*pool);
+		for (int i = 1; i < n_tasks; i++)
+		{
+			tasks.run([&function, i]() { function(i); });
+		}
+		function(0);
+		tasks.wait();
+	}
+}
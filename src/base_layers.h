@@ -1,19 +1,42 @@
 #pragma once
 
+#include <array>
+
 #include "GradMatrix.h"
 
 
 namespace MLComparison
 {
-	// abstract class template for a neural network layer
-	template<typename T, size_t input_size, size_t output_size>
+	// tag type for the constructors which create a replica of a layer or network, with its own records of the forward
+	// and backward passes but sharing the parameters of the original, so that several threads can train the original's
+	// parameters at once, each with its own replica, in the manner of Hogwild
+	struct SharedParametersTag
+	{
+	};
+
+
+	// abstract class template for a neural network layer, whose inputs and outputs are matrices
+	// with a row for each sample of a mini-batch of the given size
+	template<typename T, size_t input_size, size_t output_size, size_t batch_size = 1>
 	class Layer
 	{
 	public:
 
+		// types of the layer's elements and of its matrices of inputs and outputs, which a Sequential network uses
+		// to chain layers whose types are known at compile time
+		using value_type = T;
+		using input_type = Matrix<T, batch_size, input_size>;
+		using output_type = Matrix<T, batch_size, output_size>;
+		using grad_input_type = GradMatrix<T, batch_size, input_size>;
+		using grad_output_type = GradMatrix<T, batch_size, output_size>;
+
+		// whether the layer has trainable parameters, which a Sequential network updates
+		static constexpr bool is_trainable = false;
+
+
 		// pure virtual function which takes a pointer to an input matrix, 
 		// calculates an output matrix and returns a pointer to it
-		virtual Matrix<T, 1, output_size>* operator()(Matrix<T, 1, input_size>*) = 0;
+		virtual Matrix<T, batch_size, output_size>* operator()(Matrix<T, batch_size, input_size>*) = 0;
 
 		// pure virtual function to calculate and set the relevant gradients
 		virtual void backward() = 0;
@@ -21,11 +44,15 @@ namespace MLComparison
 
 
 	// abstract class template for a layer with trainable parameters
-	template<typename T, size_t input_size, size_t output_size>
-	class TrainableLayer : public Layer<T, input_size, output_size>
+	template<typename T, size_t input_size, size_t output_size, size_t batch_size = 1>
+	class TrainableLayer : public Layer<T, input_size, output_size, batch_size>
 	{
 	public:
 
+		// whether the layer has trainable parameters
+		static constexpr bool is_trainable = true;
+
+
 		// default constructor which sets the learning rate to 0
 		TrainableLayer()
 		{
@@ -69,15 +96,25 @@ namespace MLComparison
 	};
 
 
-	// class template for a loss function layer
-	template<typename T>
+	// class template for a loss function layer, whose input has a row for each sample of a mini-batch of the given
+	// size, of which the first n_samples are samples and any others are padding which the loss ignores
+	template<typename T, size_t batch_size = 1>
 	class LossLayer
 	{
 	public:
 
-		// pure virtual call operator function which takes a pointer
-		// to the input as well as the target number
-		virtual T operator()(Matrix<T, 1, 1>* x, T target) = 0;
+		// pure virtual call operator function which takes a pointer to the input, the target
+		// number of each row and the number of rows which are samples
+		virtual T operator()(Matrix<T, batch_size, 1>* x, const std::array<T, batch_size>& batch_targets, int batch_n_samples) = 0;
+
+		// call operator function which takes a pointer to the input as well as
+		// the target number, which is that of every row
+		T operator()(Matrix<T, batch_size, 1>* x, T target)
+		{
+			std::array<T, batch_size> batch_targets;
+			batch_targets.fill(target);
+			return (*this)(x, batch_targets, static_cast<int>(batch_size));
+		}
 
 		// pure virtual function for backward pass
 		virtual void backward() = 0;
@@ -86,20 +123,22 @@ namespace MLComparison
 	protected:
 
 		// pointer to input matrix
-		Matrix<T, 1, 1>* input_matrix = nullptr;
-		// target
-		T target = 0;
+		Matrix<T, batch_size, 1>* input_matrix = nullptr;
+		// target of each row
+		std::array<T, batch_size> targets = {};
+		// number of rows which are samples rather than padding
+		int n_samples = static_cast<int>(batch_size);
 	};
 
 
 	// struct template for a record of the forward pass, made up of
 	// a pointer to the input matrix and the matrix of outputs
-	template<typename T, size_t input_size, size_t output_size>
+	template<typename T, size_t input_size, size_t output_size, size_t batch_size = 1>
 	struct ForwardRecord
 	{
 		// pointer to the matrix of inputs
-		Matrix<T, 1, input_size>* input_matrix = nullptr;
+		Matrix<T, batch_size, input_size>* input_matrix = nullptr;
 		// matrix of outputs
-		GradMatrix<T, 1, output_size> output_matrix;
+		GradMatrix<T, batch_size, output_size> output_matrix;
 	};
 }
\ No newline at end of file
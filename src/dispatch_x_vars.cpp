@@ -0,0 +1,26 @@
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+
+#include "dispatch_x_vars.h"
+
+
+namespace MLComparison
+{
+	// function to count the independent variables in a csv file, i.e. the fields of its first line, less one
+	// for the dependent variable if the file includes it; throws std::runtime_error if the file cannot be read
+	size_t count_csv_x_vars(const std::string& csv_file, bool includes_y)
+	{
+		// read the first line of the file
+		std::ifstream infile(csv_file);
+		std::string line;
+		if (!std::getline(infile, line) || line.empty())
+		{
+			throw std::runtime_error("count_csv_x_vars: cannot read the first line of " + csv_file);
+		}
+
+		// count the fields, which are separated by commas
+		size_t n_fields = std::count(line.begin(), line.end(), ',') + 1;
+		return includes_y ? n_fields - 1 : n_fields;
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <type_traits>
+
+
+namespace MLComparison
+{
+	// number of independent variables given as the width of a dataset or model whose width is read from its
+	// csv file at run time rather than fixed at compile time, for which loops over the variables have no fixed length
+	const int dynamic_x_vars = 0;
+
+
+	// function to count the independent variables in a csv file, i.e. the fields of its first line, less one
+	// for the dependent variable if the file includes it; throws std::runtime_error if the file cannot be read
+	size_t count_csv_x_vars(const std::string& csv_file, bool includes_y = true);
+
+
+	// function template which calls the given function with a std::integral_constant holding a number of
+	// independent variables known only at run time, so that datasets of up to 8 variables are handled by
+	// templates specialized for their width, whose loops over the variables have a fixed length, and wider
+	// datasets by templates of dynamic_x_vars width, whose width is read from their csv files
+	template<typename Function>
+	auto dispatch_x_vars(size_t n_x_vars, Function&& function)
+	{
+		switch (n_x_vars)
+		{
+		case 1:
+			return function(std::integral_constant<size_t, 1>());
+		case 2:
+			return function(std::integral_constant<size_t, 2>());
+		case 3:
+			return function(std::integral_constant<size_t, 3>());
+		case 4:
+			return function(std::integral_constant<size_t, 4>());
+		case 5:
+			return function(std::integral_constant<size_t, 5>());
+		case 6:
+			return function(std::integral_constant<size_t, 6>());
+		case 7:
+			return function(std::integral_constant<size_t, 7>());
+		case 8:
+			return function(std::integral_constant<size_t, 8>());
+		default:
+			return function(std::integral_constant<size_t, dynamic_x_vars>());
+		}
+	}
+}
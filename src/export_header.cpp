@@ -0,0 +1,49 @@
+#include "export_header.h"
+
+#include <cctype>
+#include <fstream>
+#include <stdexcept>
+
+
+namespace MLComparison
+{
+	// function to format a number as a C++ floating point literal which represents it exactly, in hexadecimal notation
+	// with an f suffix if it is single precision, so that a generated header's constants are exactly the model's
+	std::string format_float_literal(double value, bool single_precision)
+	{
+		std::ostringstream literal;
+		literal << std::hexfloat << value;
+		if (single_precision)
+		{
+			literal << "f";
+		}
+		return literal.str();
+	}
+
+
+	// function to check that a name is a valid C++ identifier for a generated function; throws std::invalid_argument if not
+	void check_identifier(const std::string& name)
+	{
+		bool is_valid = !name.empty() && !std::isdigit(static_cast<unsigned char>(name[0]));
+		for (char c : name)
+		{
+			is_valid = is_valid && (std::isalnum(static_cast<unsigned char>(c)) || c == '_');
+		}
+		if (!is_valid)
+		{
+			throw std::invalid_argument("export_header: " + name + " is not a valid function name");
+		}
+	}
+
+
+	// function to write the text of a generated header to a file; throws std::runtime_error if it cannot be written
+	void write_header_file(const std::string& file_name, const std::string& text)
+	{
+		std::ofstream outfile(file_name, std::ios::trunc);
+		outfile << text;
+		if (!outfile)
+		{
+			throw std::runtime_error("export_header: cannot write " + file_name);
+		}
+	}
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <string>
+#include <sstream>
+#include <type_traits>
+
+
+namespace MLComparison
+{
+	// function to format a number as a C++ floating point literal which represents it exactly, in hexadecimal notation
+	// with an f suffix if it is single precision, so that a generated header's constants are exactly the model's
+	std::string format_float_literal(double value, bool single_precision);
+
+
+	// function to check that a name is a valid C++ identifier for a generated function; throws std::invalid_argument if not
+	void check_identifier(const std::string& name);
+
+
+	// function to write the text of a generated header to a file; throws std::runtime_error if it cannot be written
+	void write_header_file(const std::string& file_name, const std::string& text);
+
+
+	// function template which exports a trained neural network with one hidden layer of relu units and a single sigmoid
+	// output, given its weights, as a self-contained C++ header defining a function template of the given name which
+	// makes the network's prediction for a sample whose independent variables are indexed by sample[i]; the weights are
+	// constexpr arrays and the dot products are unrolled, evaluated in the same order as the network's forward pass, so
+	// that the function computes the network's outputs exactly when built without contracting products into FMAs;
+	// the first layer's weights are given input by input, with each input's weights for every hidden unit contiguous
+	template<typename T>
+	void export_network_header(const std::string& file_name, const std::string& function_name, int n_inputs, int n_hidden,
+		const T* layer_1_weights, const T* layer_1_biases, const T* layer_2_weights, T layer_2_bias)
+	{
+		static_assert(std::is_same<T, float>::value || std::is_same<T, double>::value, "networks are exported in float or double");
+		check_identifier(function_name);
+		bool single_precision = std::is_same<T, float>::value;
+		const char* type_name = single_precision ? "float" : "double";
+		auto literal = [single_precision](T value) { return format_float_literal(value, single_precision); };
+
+		std::ostringstream text;
+		text << "#pragma once\n\n#include <cmath>\n\n\n";
+		text << "// neural network with " << n_inputs << " inputs, " << n_hidden << " hidden units and one output, exported with its weights\n";
+		text << "// as constants; returns the predicted probability of the positive class for a sample indexed by sample[i]\n";
+		text << "template<typename SampleType>\ninline " << type_name << " " << function_name << "(const SampleType& sample)\n{\n";
+
+		// weights and biases
+		text << "\t// first layer's weights, input by input, and biases\n";
+		text << "\tconstexpr " << type_name << " layer_1_weights[" << n_inputs << "][" << n_hidden << "] = {\n";
+		for (int input = 0; input < n_inputs; input++)
+		{
+			text << "\t\t{ ";
+			for (int unit = 0; unit < n_hidden; unit++)
+			{
+				text << literal(layer_1_weights[input * n_hidden + unit]) << (unit + 1 < n_hidden ? ", " : " ");
+			}
+			text << (input + 1 < n_inputs ? "},\n" : "}\n");
+		}
+		text << "\t};\n\tconstexpr " << type_name << " layer_1_biases[" << n_hidden << "] = { ";
+		for (int unit = 0; unit < n_hidden; unit++)
+		{
+			text << literal(layer_1_biases[unit]) << (unit + 1 < n_hidden ? ", " : " ");
+		}
+		text << "};\n\t// second layer's weights and bias\n\tconstexpr " << type_name << " layer_2_weights[" << n_hidden << "] = { ";
+		for (int unit = 0; unit < n_hidden; unit++)
+		{
+			text << literal(layer_2_weights[unit]) << (unit + 1 < n_hidden ? ", " : " ");
+		}
+		text << "};\n\tconstexpr " << type_name << " layer_2_bias = " << literal(layer_2_bias) << ";\n\n";
+
+		// hidden units, each the dot product of the inputs and its weights plus its bias, passed through the network's
+		// relu, which is shifted down by 0.5
+		text << "\t// hidden units\n";
+		for (int unit = 0; unit < n_hidden; unit++)
+		{
+			text << "\t" << type_name << " hidden_" << unit << " = ";
+			for (int input = 0; input < n_inputs; input++)
+			{
+				text << "static_cast<" << type_name << ">(sample[" << input << "]) * layer_1_weights[" << input << "][" << unit << "] + ";
+			}
+			text << "layer_1_biases[" << unit << "];\n";
+			text << "\thidden_" << unit << " = hidden_" << unit << " > 0 ? hidden_" << unit << " - 0.5 : -0.5;\n";
+		}
+
+		// output unit
+		text << "\n\t// output unit\n\t" << type_name << " output = ";
+		for (int unit = 0; unit < n_hidden; unit++)
+		{
+			text << "hidden_" << unit << " * layer_2_weights[" << unit << "] + ";
+		}
+		text << "layer_2_bias;\n\treturn 1 / (1 + std::exp(-output));\n}\n";
+
+		write_header_file(file_name, text.str());
+	}
+}
@@ -0,0 +1,379 @@
+#include "gemm.h"
+
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+
+// the kernels are written once with GCC's vector extensions and inlined into functions compiled for each instruction
+// set, so they must always be inlined for the vector operations to use the caller's instructions, and the loops over
+// a tile's registers must be unrolled for its accumulators to stay in registers
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MLCOMPARISON_GEMM_X86 1
+#else
+#define MLCOMPARISON_GEMM_X86 0
+#endif
+#if defined(__GNUC__)
+#define MLCOMPARISON_GEMM_INLINE inline __attribute__((always_inline))
+#define MLCOMPARISON_GEMM_UNROLL _Pragma("GCC unroll 16")
+#else
+#define MLCOMPARISON_GEMM_INLINE inline
+#define MLCOMPARISON_GEMM_UNROLL
+#endif
+
+
+namespace MLComparison
+{
+	namespace
+	{
+		// sizes of the blocks of the shared dimension and of the rows of C over which packed panels are reused,
+		// chosen so that a packed panel of B stays in the L1 cache and a packed block of A in the L2 cache
+		const size_t k_block_size = 256;
+		const size_t m_block_size = 96;
+		// number of columns of C over which a packed block of B is reused, which bounds the L3 cache it occupies
+		const size_t n_block_size = 2048;
+
+
+		// alias for a pointer to a gemm function for a given element type
+		template<typename T>
+		using GemmFunction = void (*)(GemmOperation, size_t, size_t, size_t, T, const T*, const T*, T*, bool);
+
+
+		// returns element (i, p) of the left operand of a product, i.e. of A or of its transpose
+		template<typename T>
+		MLCOMPARISON_GEMM_INLINE T left_element(GemmOperation operation, const T* a, size_t m, size_t k, size_t i, size_t p)
+		{
+			return operation == GemmOperation::at_b ? a[p * m + i] : a[i * k + p];
+		}
+
+
+		// returns element (p, j) of the right operand of a product, i.e. of B or of its transpose
+		template<typename T>
+		MLCOMPARISON_GEMM_INLINE T right_element(GemmOperation operation, const T* b, size_t n, size_t k, size_t p, size_t j)
+		{
+			return operation == GemmOperation::a_bt ? b[j * k + p] : b[p * n + j];
+		}
+
+
+		// packs a block of the left operand, rows i_begin to i_begin + n_rows and columns p_begin to p_begin + n_cols,
+		// into panels of tile_rows rows in which the rows' elements for each column are contiguous, padded with zeros
+		template<typename T, size_t tile_rows>
+		MLCOMPARISON_GEMM_INLINE void pack_left(GemmOperation operation, const T* a, size_t m, size_t k, size_t i_begin, size_t n_rows,
+			size_t p_begin, size_t n_cols, T* packed)
+		{
+			for (size_t panel = 0; panel < n_rows; panel += tile_rows)
+			{
+				for (size_t p = 0; p < n_cols; p++)
+				{
+					for (size_t r = 0; r < tile_rows; r++)
+					{
+						*packed++ = panel + r < n_rows ? left_element(operation, a, m, k, i_begin + panel + r, p_begin + p) : T(0);
+					}
+				}
+			}
+		}
+
+
+		// packs a block of the right operand, rows p_begin to p_begin + n_rows and columns j_begin to j_begin + n_cols,
+		// into panels of tile_cols columns in which the panel's elements for each row are contiguous, padded with zeros
+		template<typename T, size_t tile_cols>
+		MLCOMPARISON_GEMM_INLINE void pack_right(GemmOperation operation, const T* b, size_t n, size_t k, size_t p_begin, size_t n_rows,
+			size_t j_begin, size_t n_cols, T* packed)
+		{
+			for (size_t panel = 0; panel < n_cols; panel += tile_cols)
+			{
+				for (size_t p = 0; p < n_rows; p++)
+				{
+					// rows of B are contiguous, so a panel's row is copied at once unless it is padded
+					if (operation != GemmOperation::a_bt && panel + tile_cols <= n_cols)
+					{
+						std::memcpy(packed, b + (p_begin + p) * n + j_begin + panel, tile_cols * sizeof(T));
+						packed += tile_cols;
+						continue;
+					}
+					for (size_t c = 0; c < tile_cols; c++)
+					{
+						*packed++ = panel + c < n_cols ? right_element(operation, b, n, k, p_begin + p, j_begin + panel + c) : T(0);
+					}
+				}
+			}
+		}
+
+
+		// computes a tile of tile_rows x (n_vectors * lanes) elements of C from a panel of the packed left operand and
+		// a panel of the packed right operand, holding the tile in registers as n_vectors vectors of type V per row and
+		// adding it to C, multiplied by alpha if scaled, of which only the first n_rows rows and n_cols columns are within
+		// the matrix
+		template<typename T, typename V, size_t tile_rows, size_t n_vectors, bool scaled>
+		MLCOMPARISON_GEMM_INLINE void compute_tile(size_t depth, const T* packed_a, const T* packed_b, T alpha, T* c, size_t ldc, size_t n_rows, size_t n_cols)
+		{
+			const size_t lanes = sizeof(V) / sizeof(T);
+			const size_t tile_cols = n_vectors * lanes;
+
+			// accumulate the tile over the shared dimension, multiplying each row's element of the left panel
+			// by the row of the right panel
+			V accumulators[tile_rows][n_vectors];
+			MLCOMPARISON_GEMM_UNROLL
+			for (size_t r = 0; r < tile_rows; r++)
+			{
+				MLCOMPARISON_GEMM_UNROLL
+				for (size_t v = 0; v < n_vectors; v++)
+				{
+					accumulators[r][v] = V{} * T(0);
+				}
+			}
+			for (size_t p = 0; p < depth; p++, packed_a += tile_rows, packed_b += tile_cols)
+			{
+				V b_vectors[n_vectors];
+				MLCOMPARISON_GEMM_UNROLL
+				for (size_t v = 0; v < n_vectors; v++)
+				{
+					std::memcpy(&b_vectors[v], packed_b + v * lanes, sizeof(V));
+				}
+				MLCOMPARISON_GEMM_UNROLL
+				for (size_t r = 0; r < tile_rows; r++)
+				{
+					T a_value = packed_a[r];
+					MLCOMPARISON_GEMM_UNROLL
+					for (size_t v = 0; v < n_vectors; v++)
+					{
+						accumulators[r][v] += a_value * b_vectors[v];
+					}
+				}
+			}
+
+			if (scaled)
+			{
+				MLCOMPARISON_GEMM_UNROLL
+				for (size_t r = 0; r < tile_rows; r++)
+				{
+					MLCOMPARISON_GEMM_UNROLL
+					for (size_t v = 0; v < n_vectors; v++)
+					{
+						accumulators[r][v] *= alpha;
+					}
+				}
+			}
+
+			// add the tile to C, directly if it lies within the matrix, otherwise through a buffer
+			if (n_rows == tile_rows && n_cols == tile_cols)
+			{
+				MLCOMPARISON_GEMM_UNROLL
+				for (size_t r = 0; r < tile_rows; r++)
+				{
+					MLCOMPARISON_GEMM_UNROLL
+					for (size_t v = 0; v < n_vectors; v++)
+					{
+						V c_vector;
+						std::memcpy(&c_vector, c + r * ldc + v * lanes, sizeof(V));
+						c_vector += accumulators[r][v];
+						std::memcpy(c + r * ldc + v * lanes, &c_vector, sizeof(V));
+					}
+				}
+			}
+			else
+			{
+				T tile[tile_rows][tile_cols];
+				std::memcpy(tile, accumulators, sizeof(tile));
+				for (size_t r = 0; r < n_rows; r++)
+				{
+					for (size_t col = 0; col < n_cols; col++)
+					{
+						c[r * ldc + col] += tile[r][col];
+					}
+				}
+			}
+		}
+
+
+		// computes a product of matrices by packing blocks of its operands and computing tiles of C from them, with tiles
+		// of tile_rows rows and n_vectors vectors of type V per row, and either overwrites C with it or, if accumulating,
+		// adds it multiplied by alpha to C
+		template<typename T, typename V, size_t tile_rows, size_t n_vectors>
+		MLCOMPARISON_GEMM_INLINE void gemm_blocked(GemmOperation operation, size_t m, size_t n, size_t k, T alpha, const T* a, const T* b, T* c, bool accumulate)
+		{
+			const size_t tile_cols = n_vectors * sizeof(V) / sizeof(T);
+
+			// buffers for the packed blocks, kept by each thread between calls
+			thread_local std::vector<T> packed_a;
+			thread_local std::vector<T> packed_b;
+			packed_a.resize((m_block_size + tile_rows) * k_block_size);
+			packed_b.resize((n_block_size + tile_cols) * k_block_size);
+
+			if (!accumulate)
+			{
+				std::fill(c, c + m * n, T(0));
+			}
+			// for each block of columns of C and block of the shared dimension
+			for (size_t j_block = 0; j_block < n; j_block += n_block_size)
+			{
+				size_t n_cols = std::min(n_block_size, n - j_block);
+				for (size_t p_block = 0; p_block < k; p_block += k_block_size)
+				{
+					size_t depth = std::min(k_block_size, k - p_block);
+					pack_right<T, tile_cols>(operation, b, n, k, p_block, depth, j_block, n_cols, packed_b.data());
+
+					// for each block of rows of C
+					for (size_t i_block = 0; i_block < m; i_block += m_block_size)
+					{
+						size_t n_rows = std::min(m_block_size, m - i_block);
+						pack_left<T, tile_rows>(operation, a, m, k, i_block, n_rows, p_block, depth, packed_a.data());
+
+						// compute each tile of the block of C
+						for (size_t j_tile = 0; j_tile < n_cols; j_tile += tile_cols)
+						{
+							for (size_t i_tile = 0; i_tile < n_rows; i_tile += tile_rows)
+							{
+								const T* panel_a = packed_a.data() + i_tile * depth;
+								const T* panel_b = packed_b.data() + j_tile * depth;
+								T* tile_c = c + (i_block + i_tile) * n + j_block + j_tile;
+								size_t tile_n_rows = std::min(tile_rows, n_rows - i_tile);
+								size_t tile_n_cols = std::min(tile_cols, n_cols - j_tile);
+								if (accumulate)
+								{
+									compute_tile<T, V, tile_rows, n_vectors, true>(depth, panel_a, panel_b, alpha, tile_c, n, tile_n_rows, tile_n_cols);
+								}
+								else
+								{
+									compute_tile<T, V, tile_rows, n_vectors, false>(depth, panel_a, panel_b, alpha, tile_c, n, tile_n_rows, tile_n_cols);
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+
+
+		// portable kernel, whose tiles are held as scalars which the compiler may vectorize
+		template<typename T>
+		void gemm_portable(GemmOperation operation, size_t m, size_t n, size_t k, T alpha, const T* a, const T* b, T* c, bool accumulate)
+		{
+			gemm_blocked<T, T, 4, 4>(operation, m, n, k, alpha, a, b, c, accumulate);
+		}
+
+
+#if MLCOMPARISON_GEMM_X86
+		// struct template for a vector of the given number of bytes of elements of type T
+		template<typename T, size_t n_bytes>
+		struct Vector
+		{
+			typedef T type __attribute__((vector_size(n_bytes)));
+		};
+
+
+		// kernel for processors with SSE2, with 16-byte vectors and tiles of 6 rows of 2 vectors
+		template<typename T>
+		__attribute__((target("sse2"))) void gemm_sse2(GemmOperation operation, size_t m, size_t n, size_t k, T alpha, const T* a, const T* b, T* c, bool accumulate)
+		{
+			gemm_blocked<T, typename Vector<T, 16>::type, 6, 2>(operation, m, n, k, alpha, a, b, c, accumulate);
+		}
+
+
+		// kernel for processors with AVX2 and FMA, with 32-byte vectors and tiles of 6 rows of 2 vectors
+		template<typename T>
+		__attribute__((target("avx2,fma"))) void gemm_avx2(GemmOperation operation, size_t m, size_t n, size_t k, T alpha, const T* a, const T* b, T* c, bool accumulate)
+		{
+			gemm_blocked<T, typename Vector<T, 32>::type, 6, 2>(operation, m, n, k, alpha, a, b, c, accumulate);
+		}
+
+
+		// kernel for processors with AVX-512, with 64-byte vectors and tiles of 12 rows of 2 vectors,
+		// as there are twice as many vector registers
+		template<typename T>
+		__attribute__((target("avx512f"))) void gemm_avx512(GemmOperation operation, size_t m, size_t n, size_t k, T alpha, const T* a, const T* b, T* c, bool accumulate)
+		{
+			gemm_blocked<T, typename Vector<T, 64>::type, 12, 2>(operation, m, n, k, alpha, a, b, c, accumulate);
+		}
+#endif
+
+
+		// returns the index of the instruction set supported by the processor for which a kernel exists,
+		// 3 for AVX-512, 2 for AVX2 with FMA, 1 for SSE2 and 0 for the portable kernel
+		int select_instruction_set()
+		{
+#if MLCOMPARISON_GEMM_X86
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx512f"))
+			{
+				return 3;
+			}
+			if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+			{
+				return 2;
+			}
+			if (__builtin_cpu_supports("sse2"))
+			{
+				return 1;
+			}
+#endif
+			return 0;
+		}
+
+
+		// returns the gemm function for the instruction set supported by the processor
+		template<typename T>
+		GemmFunction<T> select_gemm()
+		{
+#if MLCOMPARISON_GEMM_X86
+			switch (select_instruction_set())
+			{
+			case 3:
+				return gemm_avx512<T>;
+			case 2:
+				return gemm_avx2<T>;
+			case 1:
+				return gemm_sse2<T>;
+			}
+#endif
+			return gemm_portable<T>;
+		}
+
+
+		// returns the gemm function for the instruction set supported by the processor, selected on first use
+		template<typename T>
+		GemmFunction<T> gemm_function()
+		{
+			static const GemmFunction<T> function = select_gemm<T>();
+			return function;
+		}
+	}
+
+
+	// functions to compute the product of two matrices into an m x n matrix C stored in row-major order, overwriting it,
+	// with kernels which pack the operands into panels and accumulate tiles of C in registers over blocks of the shared
+	// dimension sized to stay in cache; the kernels use AVX-512, AVX2 with FMA or SSE2 according to the processor's
+	// CPUID on x86 with GCC or Clang, and a portable kernel otherwise, selected once on first use
+	void gemm(GemmOperation operation, size_t m, size_t n, size_t k, const float* a, const float* b, float* c)
+	{
+		gemm_function<float>()(operation, m, n, k, 1, a, b, c, false);
+	}
+
+
+	void gemm(GemmOperation operation, size_t m, size_t n, size_t k, const double* a, const double* b, double* c)
+	{
+		gemm_function<double>()(operation, m, n, k, 1, a, b, c, false);
+	}
+
+
+	// functions to add the product of two matrices multiplied by a scale alpha to an m x n matrix C stored in row-major
+	// order, i.e. C += alpha * product, with the same kernels as gemm, which add each tile to C as it is computed
+	void gemm_accumulate(GemmOperation operation, size_t m, size_t n, size_t k, float alpha, const float* a, const float* b, float* c)
+	{
+		gemm_function<float>()(operation, m, n, k, alpha, a, b, c, true);
+	}
+
+
+	void gemm_accumulate(GemmOperation operation, size_t m, size_t n, size_t k, double alpha, const double* a, const double* b, double* c)
+	{
+		gemm_function<double>()(operation, m, n, k, alpha, a, b, c, true);
+	}
+
+
+	// function to get the name of the instruction set used by gemm's kernels, i.e. "avx512", "avx2", "sse2" or "portable"
+	const char* gemm_kernel_name()
+	{
+		static const char* const names[] = { "portable", "sse2", "avx2", "avx512" };
+		return names[select_instruction_set()];
+	}
+}
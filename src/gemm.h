@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+
+
+namespace MLComparison
+{
+	// products of matrices computed by gemm, where A and B are stored in row-major order
+	enum class GemmOperation
+	{
+		// C = A * B, where A is m x k and B is k x n
+		a_b,
+		// C = transpose(A) * B, where A is k x m and B is k x n
+		at_b,
+		// C = A * transpose(B), where A is m x k and B is n x k
+		a_bt
+	};
+
+
+	// functions to compute the product of two matrices into an m x n matrix C stored in row-major order, overwriting it,
+	// with kernels which pack the operands into panels and accumulate tiles of C in registers over blocks of the shared
+	// dimension sized to stay in cache; the kernels use AVX-512, AVX2 with FMA or SSE2 according to the processor's
+	// CPUID on x86 with GCC or Clang, and a portable kernel otherwise, selected once on first use
+	void gemm(GemmOperation operation, size_t m, size_t n, size_t k, const float* a, const float* b, float* c);
+	void gemm(GemmOperation operation, size_t m, size_t n, size_t k, const double* a, const double* b, double* c);
+
+
+	// functions to add the product of two matrices multiplied by a scale alpha to an m x n matrix C stored in row-major
+	// order, i.e. C += alpha * product, with the same kernels as gemm, which add each tile to C as it is computed
+	void gemm_accumulate(GemmOperation operation, size_t m, size_t n, size_t k, float alpha, const float* a, const float* b, float* c);
+	void gemm_accumulate(GemmOperation operation, size_t m, size_t n, size_t k, double alpha, const double* a, const double* b, double* c);
+
+
+	// function to get the name of the instruction set used by gemm's kernels, i.e. "avx512", "avx2", "sse2" or "portable"
+	const char* gemm_kernel_name();
+}
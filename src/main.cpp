@@ -9,13 +9,28 @@ int main()
 {
 	// output filenames
 	std::string deep_learning_output_file = "deep_learning_results.csv";
+	std::string threaded_deep_learning_output_file = "threaded_deep_learning_results.csv";
 	std::string decision_tree_output_file = "decision_tree_results.csv";
+	std::string tree_models_output_file = "tree_models_results.csv";
+	std::string csv_deep_learning_output_file = "csv_deep_learning_results.csv";
+	std::string csv_decision_tree_output_file = "csv_decision_tree_results.csv";
+	std::string ensemble_scorer_output_file = "ensemble_scorer_results.csv";
 
 	// test each algorithm and output timings to file
 	std::cout << "Training and validating deep learning algorithm... (Writing results to " << deep_learning_output_file << ")" << std::endl;
 	MLComparison::test_neural_network<float>(deep_learning_output_file);
+	std::cout << "Training deep learning algorithm on multiple threads... (Writing results to " << threaded_deep_learning_output_file << ")" << std::endl;
+	MLComparison::test_neural_network_threads<float>(threaded_deep_learning_output_file);
 	std::cout << "Training and validating decision tree algorithm... (Writing results to " << decision_tree_output_file << ")" << std::endl;
 	MLComparison::test_decision_tree(decision_tree_output_file);
+	std::cout << "Training and validating other tree-based algorithms... (Writing results to " << tree_models_output_file << ")" << std::endl;
+	MLComparison::test_tree_models(tree_models_output_file);
+	std::cout << "Training deep learning algorithm on a dataset of the width of its file... (Writing results to " << csv_deep_learning_output_file << ")" << std::endl;
+	MLComparison::test_neural_network_csv<float>("banknote_train.csv", "banknote_valid.csv", csv_deep_learning_output_file);
+	std::cout << "Training decision tree algorithm on a dataset of the width of its file... (Writing results to " << csv_decision_tree_output_file << ")" << std::endl;
+	MLComparison::test_decision_tree_csv("banknote_train.csv", "banknote_valid.csv", csv_decision_tree_output_file);
+	std::cout << "Timing ensemble prediction methods... (Writing results to " << ensemble_scorer_output_file << ")" << std::endl;
+	MLComparison::test_ensemble_scorer(ensemble_scorer_output_file);
 
 	return 0;
 }
\ No newline at end of file
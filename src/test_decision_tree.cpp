@@ -1,3 +1,6 @@
+#include <chrono>
+#include <vector>
+
 #include "test_decision_tree.h"
 
 
@@ -34,4 +37,137 @@ namespace MLComparison
 			}
 		}
 	}
+
+
+	// function template to record the training time of a tree-based model of the given type, named in the timings
+	// file, using different numbers of training samples and independent variables within these
+	template<typename ModelType>
+	void test_tree_model(std::ofstream& timings_file, const std::string& model_name)
+	{
+		// for each number of independent variables to use from 1 to 4
+		for (int x_vars_to_use = 1; x_vars_to_use <= 4; x_vars_to_use++)
+		{
+			// for each number of eighths of the training samples to use from 1 to 8
+			for (int eighths_rows_to_use = 1; eighths_rows_to_use <= 8; eighths_rows_to_use++)
+			{
+				// create model
+				ModelType model("banknote_train.csv", "banknote_valid.csv");
+				// record training time
+				auto train_time = model.train(eighths_rows_to_use, x_vars_to_use);
+				// write details to timings file
+				timings_file << model_name << "," << eighths_rows_to_use << "," << x_vars_to_use << "," << train_time;
+				// record validation time
+				auto valid_time = model.validate(eighths_rows_to_use);
+				// write details to csv file
+				timings_file << "," << valid_time << "," << model.get_accuracy() << std::endl;
+			}
+		}
+	}
+
+
+	// function to record the training time of the gradient boosting, Hoeffding tree and sparse decision tree
+	// algorithms using different numbers of training samples and independent variables within these
+	void test_tree_models(const std::string& train_timings_csv)
+	{
+		// open timings file
+		std::ofstream timings_file(train_timings_csv, std::ios::trunc);
+		// write file header
+		timings_file << "model,samples_proportion,x_vars_proportion,train_time,valid_time,accuracy" << std::endl;
+		// take 10 measurements of each combination of numbers of rows and columns to use for each model
+		for (int i = 0; i < 10; i++)
+		{
+			test_tree_model<GradientBoostingModel<double, 4>>(timings_file, "gradient_boosting");
+			test_tree_model<HoeffdingTreeModel<double, 4>>(timings_file, "hoeffding_tree");
+			test_tree_model<SparseDecisionTreeModel<double>>(timings_file, "sparse_decision_tree");
+		}
+	}
+
+
+	// function to record the training time of the decision tree algorithm on a training and validation set of any
+	// width, which is read from the training set's csv file, so that a model specialized for its width is trained
+	// if it is small and a model of dynamic width otherwise
+	void test_decision_tree_csv(const std::string& train_csv, const std::string& valid_csv, const std::string& train_timings_csv)
+	{
+		// open timings file
+		std::ofstream timings_file(train_timings_csv, std::ios::trunc);
+		// write file header
+		timings_file << "x_vars,dynamic_width,train_time,valid_time,accuracy" << std::endl;
+		// take 100 measurements of the model for the width of the training set, using all of its variables
+		size_t n_x_vars = count_csv_x_vars(train_csv);
+		dispatch_x_vars(n_x_vars, [&](auto x_vars) {
+			for (int i = 0; i < 100; i++)
+			{
+				// create model
+				DecisionTreeModel<double, decltype(x_vars)::value> model(train_csv, valid_csv);
+				// record training and validation times
+				auto train_time = model.train(8, n_x_vars);
+				auto valid_time = model.validate(8);
+				// write details to timings file
+				timings_file << n_x_vars << "," << (decltype(x_vars)::value == dynamic_x_vars) << "," << train_time << ","
+					<< valid_time << "," << model.get_accuracy() << std::endl;
+			}
+		});
+	}
+
+
+	// function to record the time taken to predict the validation set with a random forest by recursing through
+	// each tree's nodes, by walking each tree's compiled array of nodes and by the QuickScorer method, using
+	// different numbers of trees
+	void test_ensemble_scorer(const std::string& predict_timings_csv)
+	{
+		using the_clock = std::chrono::steady_clock;
+
+		// open timings file
+		std::ofstream timings_file(predict_timings_csv, std::ios::trunc);
+		// write file header
+		timings_file << "n_trees,recursive_time,flat_time,quick_scorer_time,agreement" << std::endl;
+		// load the validation set, whose samples are predicted
+		DecisionTreeDataset<double, 4> validation_set("banknote_valid.csv");
+		std::vector<int> recursive_predictions(validation_set.size());
+		std::vector<int> flat_predictions(validation_set.size());
+		std::vector<int> quick_scorer_predictions(validation_set.size());
+		// for each number of trees
+		for (int n_trees : { 1, 10, 100, 500 })
+		{
+			// train a forest, whose trees have at most 64 leaves at the default maximum depth
+			RandomForestModel<double, 4> model("banknote_train.csv", "banknote_valid.csv", n_trees);
+			model.train(8, 4);
+			std::vector<const DecisionTreeNode<double, 4>*> roots = model.get_root_nodes();
+			QuickScorer<double, 4> quick_scorer(roots);
+
+			// take 30 measurements of each method
+			for (int i = 0; i < 30; i++)
+			{
+				// predict by recursing through each tree's nodes
+				the_clock::time_point start = the_clock::now();
+				for (size_t row = 0; row < validation_set.size(); row++)
+				{
+					int votes = 0;
+					for (const auto* root : roots)
+					{
+						votes += root->predict(validation_set[row]);
+					}
+					recursive_predictions[row] = 2 * votes > n_trees ? 1 : 0;
+				}
+				the_clock::time_point end = the_clock::now();
+				auto recursive_time = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+				// predict by walking each tree's compiled array of nodes
+				start = the_clock::now();
+				model.predict_batch(validation_set.begin(), validation_set.end(), flat_predictions.begin());
+				end = the_clock::now();
+				auto flat_time = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+				// predict by the QuickScorer method
+				start = the_clock::now();
+				quick_scorer.predict_batch(validation_set.begin(), validation_set.end(), quick_scorer_predictions.begin());
+				end = the_clock::now();
+				auto quick_scorer_time = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+				// write details to timings file, with whether the QuickScorer method made the same predictions as recursion
+				timings_file << n_trees << "," << recursive_time << "," << flat_time << "," << quick_scorer_time << ","
+					<< (quick_scorer_predictions == recursive_predictions) << std::endl;
+			}
+		}
+	}
 }
\ No newline at end of file
@@ -4,6 +4,12 @@
 #include <fstream>
 
 #include "DecisionTreeModel.h"
+#include "RandomForestModel.h"
+#include "QuickScorer.h"
+#include "GradientBoostingModel.h"
+#include "HoeffdingTreeModel.h"
+#include "SparseDecisionTreeModel.h"
+#include "dispatch_x_vars.h"
 
 
 namespace MLComparison
@@ -11,4 +17,21 @@ namespace MLComparison
 	// function to record the training time of the decision tree algorithm using
 	// different numbers of training samples and independent variables within these
 	void test_decision_tree(const std::string& train_timings_csv);
+
+
+	// function to record the training time of the decision tree algorithm on a training and validation set of any
+	// width, which is read from the training set's csv file, so that a model specialized for its width is trained
+	// if it is small and a model of dynamic width otherwise
+	void test_decision_tree_csv(const std::string& train_csv, const std::string& valid_csv, const std::string& train_timings_csv);
+
+
+	// function to record the training time of the gradient boosting, Hoeffding tree and sparse decision tree
+	// algorithms using different numbers of training samples and independent variables within these
+	void test_tree_models(const std::string& train_timings_csv);
+
+
+	// function to record the time taken to predict the validation set with a random forest by recursing through
+	// each tree's nodes, by walking each tree's compiled array of nodes and by the QuickScorer method, using
+	// different numbers of trees
+	void test_ensemble_scorer(const std::string& predict_timings_csv);
 }
\ No newline at end of file
@@ -2,8 +2,11 @@
 
 #include <string>
 #include <fstream>
+#include <memory>
+#include <utility>
 
 #include "NeuralNetModel.h"
+#include "dispatch_x_vars.h"
 
 
 namespace MLComparison
@@ -60,4 +63,66 @@ namespace MLComparison
 		// close timings file
 		train_timings_file.close();
 	}
+
+
+	// function template to time the training of a neural network on a training and validation set of any width,
+	// which is read from the training set's csv file, so that a network specialized for its width is trained if
+	// it is small and a network of dynamic width otherwise
+	template<typename T>
+	void test_neural_network_csv(const std::string& train_csv, const std::string& valid_csv, const std::string& timings_csv)
+	{
+		// open the given timings file
+		std::ofstream timings_file(timings_csv, std::ios::trunc);
+		// write header to timings file
+		timings_file << "x_vars,dynamic_width,train_time,valid_time,accuracy" << std::endl;
+
+		// take 10 measurements of the model for the width of the training set
+		size_t n_x_vars = count_csv_x_vars(train_csv);
+		dispatch_x_vars(n_x_vars, [&](auto x_vars) {
+			for (int i = 0; i < 10; i++)
+			{
+				// create a model and record its training and validation times
+				NeuralNetModel<T, decltype(x_vars)::value> model(train_csv, valid_csv, 0.1);
+				auto train_time = model.train(8, 5);
+				auto valid_time = model.validate(8);
+				// write details to timings file
+				timings_file << n_x_vars << "," << (decltype(x_vars)::value == dynamic_x_vars) << "," << train_time << ","
+					<< valid_time << "," << model.get_accuracy() << std::endl;
+			}
+		});
+	}
+
+
+	// function template to time the training of a neural network on different numbers of threads, where each model
+	// is trained, moved to another model, whose training is continued after the moved-from model is destroyed, so
+	// that the threads must train the parameters of the model to which it was moved
+	template<typename T>
+	void test_neural_network_threads(const std::string& timings_csv)
+	{
+		// open the given timings file
+		std::ofstream timings_file(timings_csv, std::ios::trunc);
+		// write header to timings file
+		timings_file << "n_threads,first_train_time,second_train_time,valid_time,accuracy" << std::endl;
+
+		// take 10 measurements of each number of threads
+		for (int i = 0; i < 10; i++)
+		{
+			for (int n_threads = 1; n_threads <= 4; n_threads++)
+			{
+				// create a model on the heap and train it on the given number of threads
+				std::unique_ptr<NeuralNetModel<T, 4>> first_model_ptr(new NeuralNetModel<T, 4>(make_banknote_authentication_nn_model<T, 4>(0.1)));
+				first_model_ptr->set_n_threads(n_threads);
+				auto first_train_time = first_model_ptr->train(8, 5);
+				// move the model and destroy the moved-from model before training the model to which it was moved
+				NeuralNetModel<T, 4> model(std::move(*first_model_ptr));
+				first_model_ptr.reset();
+				auto second_train_time = model.train(8, 5);
+				// record the model's validation time
+				auto valid_time = model.validate(8);
+				// write details to timings file
+				timings_file << n_threads << "," << first_train_time << "," << second_train_time << "," << valid_time << ","
+					<< model.get_accuracy() << std::endl;
+			}
+		}
+	}
 }
\ No newline at end of file